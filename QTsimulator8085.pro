@@ -8,30 +8,65 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x050000    # disables all the APIs depr
 
 SOURCES += \
     assembler.cpp \
+    backgroundassembler.cpp \
     commdefs.cpp \
     debugtable.cpp \
+    disassembler.cpp \
+    disassemblymodel.cpp \
     editor.cpp \
+    expression.cpp \
     finddialog.cpp \
     iomodel.cpp \
+    keyboard8279.cpp \
+    linker.cpp \
+    listing.cpp \
     main.cpp \
     mainwindow.cpp \
     memorymodel.cpp \
     opcodes.cpp \
+    ppi8255.cpp \
     processor.cpp \
-    syntaxhighlighter.cpp
+    scheduler.cpp \
+    serialconsole.cpp \
+    serialendpoint.cpp \
+    seriallineuart.cpp \
+    stringpool.cpp \
+    symboltable.cpp \
+    syntaxhighlighter.cpp \
+    timer8253.cpp \
+    trainerpanel.cpp \
+    usart8251.cpp
 
 HEADERS += \
     assembler.h \
+    backgroundassembler.h \
     commdefs.h \
     debugtable.h \
+    disassembler.h \
+    disassemblymodel.h \
     editor.h \
+    expression.h \
     finddialog.h \
+    iodevice.h \
     iomodel.h \
+    keyboard8279.h \
+    linker.h \
+    listing.h \
     mainwindow.h \
     memorymodel.h \
     opcodes.h \
+    ppi8255.h \
     processor.h \
-    syntaxhighlighter.h
+    scheduler.h \
+    serialconsole.h \
+    serialendpoint.h \
+    seriallineuart.h \
+    stringpool.h \
+    symboltable.h \
+    syntaxhighlighter.h \
+    timer8253.h \
+    trainerpanel.h \
+    usart8251.h
 
 FORMS += \
     finddialog.ui \
@@ -20,6 +20,8 @@ furnished to do so, subject to the following conditions:
     OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
     SOFTWARE.*/
 #include "assembler.h"
+#include <QFile>
+#include <QFileInfo>
 
 //SyntaxError
 
@@ -29,171 +31,185 @@ inline SyntaxError::SyntaxError(const Tokenizer &tok, const char *const what)
 //Tokenizer
 
 Tokenizer::TokenType Tokenizer::getNextToken() {
-    char ch;
-    token.clear();
-    ttype = NONE;
+    const size_t start = position;
+    token = TokenView(source + start, start, 0u);
+    ttype = NONE; mnemonic = NO_MNEMONIC;
     //check for EOF
     if(isEndOfFile()) return ttype = END_OF_FILE;
-    //check for errors
-    if(!isGood()) return ttype = STREAM_ERROR;
-    //check for non-newline whitespace
-    if(std::isspace(ch = peekNextChar()) && ch != '\n') {
-        //while stream is good and the next character is space and not newline...
-        while(isGood() && std::isspace(ch = getNextChar()) && ch != '\n') token.append(1, ch);
-        if(isGood()) putBackChar(ch); //put back the character which did not follow rule
-        columnNumber += token.length();
-        return ttype = WHITESPACE;
-    }
+    const char ch = source[position];
     //check for newline
-    if(peekNextChar() == '\n') {
-        token.append(1, '\n');
-        getNextChar(); //advance
+    if(ch == '\n') {
+        position++; token.size = 1u;
         lineNumber++; columnNumber=1;
         return ttype = NEWLINE;
     }
+    //check for non-newline whitespace
+    if(std::isspace((unsigned char)ch)) {
+        //while there is input and the next character is space and not newline...
+        while(position < sourceLength && std::isspace((unsigned char)source[position]) && source[position] != '\n') position++;
+        ttype = WHITESPACE;
+    }
     //check for separator
-    if(isSeparator(ch = peekNextChar())) {
-        token.append(1, ch);
-        getNextChar(); //advance
-        columnNumber++;
-        return ttype = SEPARATOR;
+    else if(isSeparator(ch)) {
+        position++;
+        ttype = SEPARATOR;
+    }
+    //$ followed by hexadecimal digits is a number; $ alone is an operator.
+    else if(ch == '$' && readDollarNumber()) ttype = HEXNUMBER;
+    //operators of operand expressions
+    else if(isOperator(ch)) {
+        position++;
+        ttype = OPERATOR;
     }
     //alphanumeric characters checked here
-    if(std::isalnum(ch = peekNextChar())) {
-        //while stream is good and next character is alphanumeric...
-        while(isGood() && std::isalnum(ch = getNextChar())) token.append(1, ch);
-        if(isGood()) putBackChar(ch); //put back the character which did not follow rule
-        columnNumber+=token.length();
-        //now to see whether OPCODE, IDENTIFIER, NUMBER, or HEXNUMBER
-        if(isOpcode(token.c_str())) return ttype = OPCODE;
-        else if(isPseudocode(token.c_str())) return ttype = PSEUDOCODE;
-        //Notice the order of calls below. Maintain this.
-        //DECNUMBER first 12D can be treated as an implicit hex number.
-        else if(isBinNumber(token.c_str())) return ttype = BINNUMBER;
-        else if(isOctNumber(token.c_str())) return ttype = OCTNUMBER;
-        else if(isDecimalNumber(token.c_str())) return ttype = DECNUMBER;
-        else if(isImplicitHexNumber(token.c_str()) || isHexNumber(token.c_str())) return ttype = HEXNUMBER;
-        else return ttype = IDENTIFIER; //unrecognized alphanumeric sequences may be identifiers
+    else if(std::isalnum((unsigned char)ch)) ttype = readWord();
+    //Local labels: a '.' followed by an alphanumeric sequence. Always identifiers.
+    else if(ch == '.' && position + 1u < sourceLength && std::isalnum((unsigned char)source[position + 1u])) {
+        position++;
+        while(position < sourceLength && std::isalnum((unsigned char)source[position])) position++;
+        ttype = IDENTIFIER;
+    }
+    //Strings end at the matching quote on the same line; an unterminated quote is an unrecognized character.
+    else if(ch == '\'' || ch == '"') {
+        const char *const s = source + position + 1u;
+        const void *const quote = std::memchr(s, ch, sourceLength - position - 1u);
+        const void *const newline = std::memchr(s, '\n', sourceLength - position - 1u);
+        if(quote == nullptr || (newline != nullptr && newline < quote)) return ttype = CHAR_ERROR;
+        position = (size_t)((const char *)quote - source) + 1u;
+        ttype = STRING;
     }
     //Comments
-    if((ch = peekNextChar()) == ';') {
-        //while stream is good and we do not encounter a newline...
-        while(isGood() && (ch = getNextChar()) != '\n') token.append(1, ch);
-        if(isGood()) putBackChar(ch); //put back the character which did not follow rule
-        columnNumber+=token.length();
-        return ttype = COMMENT;
+    else if(ch == ';') {
+        //while there is input and we do not encounter a newline...
+        const void *const newline = std::memchr(source + position, '\n', sourceLength - position);
+        position = newline != nullptr ? (size_t)((const char *)newline - source) : sourceLength;
+        ttype = COMMENT;
     }
-    //if we reach here, the underlying stream might have had an error irrespective of putback buffer
-    if(in.eof()) return ttype = END_OF_FILE;
-    if(!in.good()) return ttype = STREAM_ERROR;
-    return ttype = CHAR_ERROR; //unrecognized character
+    else return ttype = CHAR_ERROR; //unrecognized character
+    token.size = position - start;
+    columnNumber += token.size;
+    return ttype;
 }
-char Tokenizer::getNextChar() {
-    if(putbackBuffer.empty()) return in.get();
-    else {
-        char temp = putbackBuffer.top();
-        putbackBuffer.pop();
-        return temp;
+
+///Append a digit to a number being converted, saturating at Tokenizer::NUMBER_OVERFLOW.
+static inline uint_least32_t appendDigit(uint_least32_t x, unsigned base, unsigned digit) {
+    if(x >= Tokenizer::NUMBER_OVERFLOW) return x;
+    x = x * base + digit;
+    return x >= Tokenizer::NUMBER_OVERFLOW ? (uint_least32_t)Tokenizer::NUMBER_OVERFLOW : x;
+}
+Tokenizer::TokenType Tokenizer::readWord() {
+    const char *const s = source + position;
+    //Every character but the last is converted in all four bases at once, as long as it is a digit of the base; the last one
+    //is either a suffix (b, o, d or h) or the last digit of a hexadecimal number without one. 0x in front of hexadecimal
+    //digits is a prefix.
+    enum {BIN = 1, OCT = 2, DEC = 4, HEX = 8};
+    unsigned bases = BIN | OCT | DEC | HEX;
+    uint_least32_t bin = 0u, oct = 0u, dec = 0u, hex = 0u;
+    bool prefixed = false;
+    size_t len = 1u;
+    for(; position + len < sourceLength && std::isalnum((unsigned char)s[len]); len++) {
+        const unsigned digit = digitValue(s[len-1u]);
+        if(len == 2u && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {prefixed = true; bases = HEX; continue;}
+        if(digit >= 16u) bases = 0u;
+        if(bases == 0u) continue; //an identifier; read on to its end
+        if(digit >= 10u) bases &= HEX;
+        else if(digit >= 8u) bases &= DEC | HEX;
+        else if(digit >= 2u) bases &= OCT | DEC | HEX;
+        bin = appendDigit(bin, 2u, digit); oct = appendDigit(oct, 8u, digit);
+        dec = appendDigit(dec, 10u, digit); hex = appendDigit(hex, 16u, digit);
+    }
+    position += len;
+    //Mnemonics never start with a digit, numbers usually do.
+    if(!std::isdigit((unsigned char)s[0]) && (mnemonic = findMnemonic(s, len)) != NO_MNEMONIC)
+        return isPseudocodeMnemonic(mnemonic) ? PSEUDOCODE : OPCODE;
+    //Notice the order of checks below. Maintain this. 101B is binary, 12D decimal, and either is a hex number without suffix.
+    const char last = (char)std::toupper((unsigned char)s[len-1u]);
+    const unsigned lastDigit = digitValue(last);
+    if(len > 1u && !prefixed) {
+        if((bases & BIN) && last == 'B') {number = bin; return BINNUMBER;}
+        if((bases & OCT) && last == 'O') {number = oct; return OCTNUMBER;}
+        if((bases & DEC) && last == 'D') {number = dec; return DECNUMBER;}
     }
+    if((bases & HEX) && std::isdigit((unsigned char)s[0]) && lastDigit < 16u && (len > 2u || !prefixed)) {
+        number = appendDigit(hex, 16u, lastDigit); return HEXNUMBER;
+    }
+    if((bases & HEX) && len > 1u && !prefixed && last == 'H') {number = hex; return HEXNUMBER;}
+    return IDENTIFIER; //unrecognized alphanumeric sequences may be identifiers
 }
-char Tokenizer::peekNextChar() {
-    if(putbackBuffer.empty()) {
-        char temp = in.get();
-        putbackBuffer.push(temp);
-        return temp;
+bool Tokenizer::readDollarNumber() {
+    size_t end = position + 1u;
+    uint_least32_t x = 0u;
+    for(; end < sourceLength && std::isalnum((unsigned char)source[end]); end++) {
+        const unsigned digit = digitValue(source[end]);
+        if(digit >= 16u) return false;
+        x = appendDigit(x, 16u, digit);
     }
-    else return putbackBuffer.top();
+    if(end == position + 1u) return false;
+    position = end; number = x;
+    return true;
 }
 
 //LineTranslator
 
-static data8_t convertNumberByte(const Tokenizer &tok) {
-    unsigned long long x = 0xFFu + 1;
+///Value of a number token (already converted by the tokenizer); Tokenizer::NUMBER_OVERFLOW if it does not fit in 16 bits.
+static unsigned long convertNumber(const Tokenizer &tok) {
     switch(tok.ttype) {
-    case Tokenizer::BINNUMBER:
-        //Custom converter required
-        x = 0;
-        for(size_t i = 0; i < tok.token.length()-1; i++) {
-            x <<= 1;
-            if(tok.token[i] == '1') x |= 1u;
-        }
-        break;
-    case Tokenizer::OCTNUMBER:
-        std::sscanf(tok.token.c_str(), "%llo%*[oO]", &x);
-        break;
-    case Tokenizer::DECNUMBER:
-        std::sscanf(tok.token.c_str(), "%llu%*[dD]", &x);
-        break;
-    case Tokenizer::HEXNUMBER:
-        std::sscanf(tok.token.c_str(), "%llx%*[hH]", &x);
-        break;
-    default: throw SyntaxError(tok, "Expected a nonnegative number less than or equal to 255 or FFH");
+    case Tokenizer::BINNUMBER: case Tokenizer::OCTNUMBER: case Tokenizer::DECNUMBER: case Tokenizer::HEXNUMBER: return tok.number;
+    default: return Tokenizer::NUMBER_OVERFLOW; //not a number; always out of range
     }
+}
+static data8_t convertNumberByte(const Tokenizer &tok) {
+    const unsigned long x = convertNumber(tok);
     if(x > 255u) throw SyntaxError(tok, "Expected a nonnegative number less than or equal to 255 or FFH");
     return (data8_t)(x & 0xFFu);
 }
 static data16_t convertNumberWord(const Tokenizer &tok) {
-    unsigned long long x = 0xFFFFu + 1;
-    switch(tok.ttype) {
-    case Tokenizer::BINNUMBER:
-        //Custom converter required
-        x = 0;
-        for(size_t i = 0; i < tok.token.length()-1; i++) {
-            if(tok.token[i] == '1') x |= 1u;
-            x <<= 1;
-        }
-        break;
-    case Tokenizer::OCTNUMBER:
-        std::sscanf(tok.token.c_str(), "%llo%*[oO]", &x);
-        break;
-    case Tokenizer::DECNUMBER:
-        std::sscanf(tok.token.c_str(), "%llu%*[dD]", &x);
-        break;
-    case Tokenizer::HEXNUMBER:
-        std::sscanf(tok.token.c_str(), "%llx%*[hH]", &x);
-        break;
-    default: throw SyntaxError(tok, "Expected a nonnegative number less than or equal to 65535 or FFFFH");
-    }
+    const unsigned long x = convertNumber(tok);
     if(x > 0xFFFFu) throw SyntaxError(tok, "Expected a nonnegative number less than or equal to 65535 or FFFFH");
     return (data16_t)(x & 0xFFFFu);
 }
 
-LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
+///Identifier of a mnemonic known to exist.
+static mnemonic_t mnemonicId(const char *name) {return findMnemonic(name, std::strlen(name));}
+
+LineTranslator::LineTranslator(Tokenizer &tok, StringPool *stringPool, std::vector<data8_t> *dataArena, std::vector<ExprItem> *expressionArena)
+    : tok(tok), pool(stringPool), arena(dataArena), expressions(expressionArena), mnemonicProcessors(mnemonicCount()),
+      pseudocodeProcessors(mnemonicCount()), depth(0u), nesting(0u), lastToken(tok) {
     /*Mnemonic processors should catch most syntax and semantic errors.
     Mnemonic processors accept an Instruction reference to suitably modify; and the mnemonic for which they were called.
     In some cases; they will modify the i.code field to some valid object (not nullptr) if the processor has enough
     information to resolve the instruction. In any case, instruction bytecode resolution is finished in this stage itself.*/
-    const std::function<void(Instruction &, const char *)> noOperandProc = [&](Instruction &i, const char *name){i.code = getOpcode(name);}; //Call when the instruction doesn't require any operands
-    mnemonicProcessors.insert({"NOP", noOperandProc});
-    mnemonicProcessors.insert({"HLT", noOperandProc});
-    mnemonicProcessors.insert({"RLC", noOperandProc});
-    mnemonicProcessors.insert({"RRC", noOperandProc});
-    mnemonicProcessors.insert({"RAL", noOperandProc});
-    mnemonicProcessors.insert({"RAR", noOperandProc});
-    mnemonicProcessors.insert({"RIM", noOperandProc});
-    mnemonicProcessors.insert({"SIM", noOperandProc});
-    mnemonicProcessors.insert({"DAA", noOperandProc});
-    mnemonicProcessors.insert({"CMA", noOperandProc});
-    mnemonicProcessors.insert({"STC", noOperandProc});
-    mnemonicProcessors.insert({"CMC", noOperandProc});
-    mnemonicProcessors.insert({"RET", noOperandProc});
-    mnemonicProcessors.insert({"RNZ", noOperandProc});
-    mnemonicProcessors.insert({"RZ", noOperandProc});
-    mnemonicProcessors.insert({"RNC", noOperandProc});
-    mnemonicProcessors.insert({"RC", noOperandProc});
-    mnemonicProcessors.insert({"RPO", noOperandProc});
-    mnemonicProcessors.insert({"RPE", noOperandProc});
-    mnemonicProcessors.insert({"RP", noOperandProc});
-    mnemonicProcessors.insert({"RM", noOperandProc});
-    mnemonicProcessors.insert({"PCHL", noOperandProc});
-    mnemonicProcessors.insert({"SPHL", noOperandProc});
-    mnemonicProcessors.insert({"XTHL", noOperandProc});
-    mnemonicProcessors.insert({"XCHG", noOperandProc});
-    mnemonicProcessors.insert({"DI", noOperandProc});
-    mnemonicProcessors.insert({"EI", noOperandProc});
-
-    const std::function<void(Instruction &, const char *)> byteProc = [&](Instruction &i, const char *name) { //Call when the instruction requires a byte number as the operand (say 243 or 23H, etc.)
-        i.code = getOpcode(name); //Wherever this occurs this has to be the first call. The name pointer points to a resource that may change unintentionally. (Rust vibes anyone?)
+    const std::function<void(Instruction &, mnemonic_t)> noOperandProc = [&](Instruction &i, mnemonic_t mnemonic){i.code = getOpcode(mnemonic);}; //Call when the instruction doesn't require any operands
+    mnemonicProcessors[mnemonicId("NOP")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("HLT")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RLC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RRC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RAL")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RAR")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RIM")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("SIM")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("DAA")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("CMA")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("STC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("CMC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RET")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RNZ")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RZ")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RNC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RC")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RPO")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RPE")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RP")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("RM")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("PCHL")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("SPHL")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("XTHL")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("XCHG")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("DI")] = noOperandProc;
+    mnemonicProcessors[mnemonicId("EI")] = noOperandProc;
+
+    const std::function<void(Instruction &, mnemonic_t)> byteProc = [&](Instruction &i, mnemonic_t mnemonic) { //Call when the instruction requires a byte number as the operand (say 243 or 23H, etc.)
+        i.code = getOpcode(mnemonic);
         ignoreWhitespaces();
         /*if(tok.ttype == Tokenizer::DECNUMBER) {
             unsigned x; std::sscanf(tok.token.c_str(), "%u%*[dD]", &x);
@@ -216,21 +232,21 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = x & 0xFFu;
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFH or 255");*/
-        i.operand = convertNumberByte(tok);
+        parseOperand(i, true);
     };
-    mnemonicProcessors.insert({"ADI", byteProc});
-    mnemonicProcessors.insert({"ACI", byteProc});
-    mnemonicProcessors.insert({"SUI", byteProc});
-    mnemonicProcessors.insert({"SBI", byteProc});
-    mnemonicProcessors.insert({"ANI", byteProc});
-    mnemonicProcessors.insert({"XRI", byteProc});
-    mnemonicProcessors.insert({"ORI", byteProc});
-    mnemonicProcessors.insert({"CPI", byteProc});
-    mnemonicProcessors.insert({"OUT", byteProc});
-    mnemonicProcessors.insert({"IN", byteProc});
-
-    const std::function<void(Instruction &, const char *)> wordProc = [&](Instruction &i, const char *name) { //Call when the instruction requires a 2-byte number as the operand (say 16384 or 2312H, etc.)
-        i.code = getOpcode(name);
+    mnemonicProcessors[mnemonicId("ADI")] = byteProc;
+    mnemonicProcessors[mnemonicId("ACI")] = byteProc;
+    mnemonicProcessors[mnemonicId("SUI")] = byteProc;
+    mnemonicProcessors[mnemonicId("SBI")] = byteProc;
+    mnemonicProcessors[mnemonicId("ANI")] = byteProc;
+    mnemonicProcessors[mnemonicId("XRI")] = byteProc;
+    mnemonicProcessors[mnemonicId("ORI")] = byteProc;
+    mnemonicProcessors[mnemonicId("CPI")] = byteProc;
+    mnemonicProcessors[mnemonicId("OUT")] = byteProc;
+    mnemonicProcessors[mnemonicId("IN")] = byteProc;
+
+    const std::function<void(Instruction &, mnemonic_t)> wordProc = [&](Instruction &i, mnemonic_t mnemonic) { //Call when the instruction requires a 2-byte number as the operand (say 16384 or 2312H, etc.)
+        i.code = getOpcode(mnemonic);
         ignoreWhitespaces();
        /* if(tok.ttype == Tokenizer::DECNUMBER) {
             unsigned long long x; std::sscanf(tok.token.c_str(), "%llu%*[dD]", &x);
@@ -243,53 +259,49 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = (data16_t)(x & 0xFFFFu);
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFFFH or 65535");*/
-        i.operand = convertNumberWord(tok);
+        parseOperand(i, false);
     };
-    mnemonicProcessors.insert({"SHLD", wordProc});
-    mnemonicProcessors.insert({"LHLD", wordProc});
-    mnemonicProcessors.insert({"STA", wordProc});
-    mnemonicProcessors.insert({"LDA", wordProc});
+    mnemonicProcessors[mnemonicId("SHLD")] = wordProc;
+    mnemonicProcessors[mnemonicId("LHLD")] = wordProc;
+    mnemonicProcessors[mnemonicId("STA")] = wordProc;
+    mnemonicProcessors[mnemonicId("LDA")] = wordProc;
 
-    const std::function<void(Instruction &, const char *)> labelProc = [&](Instruction &i, const char *name) { //Call when the instruction takes a label as argument (jumps and calls)
-        i.code = getOpcode(name);
+    const std::function<void(Instruction &, mnemonic_t)> labelProc = [&](Instruction &i, mnemonic_t mnemonic) { //Call when the instruction takes a label as argument (jumps and calls)
+        i.code = getOpcode(mnemonic);
         ignoreWhitespaces();
-        try {i.operand = convertNumberWord(tok);} catch (SyntaxError const &) {
-            if(tok.ttype != Tokenizer::IDENTIFIER)
-                throw SyntaxError(tok, "Expected an identifier(target label) or address");
-            i.toLabel = tok.token;
-        }
+        parseOperand(i, false); //a label, an address or any expression of them
     };
-    mnemonicProcessors.insert({"JMP", labelProc});
-    mnemonicProcessors.insert({"JNZ", labelProc});
-    mnemonicProcessors.insert({"JZ", labelProc});
-    mnemonicProcessors.insert({"JNC", labelProc});
-    mnemonicProcessors.insert({"JC", labelProc});
-    mnemonicProcessors.insert({"JPO", labelProc});
-    mnemonicProcessors.insert({"JPE", labelProc});
-    mnemonicProcessors.insert({"JP", labelProc});
-    mnemonicProcessors.insert({"JM", labelProc});
-    mnemonicProcessors.insert({"CALL", labelProc});
-    mnemonicProcessors.insert({"CNZ", labelProc});
-    mnemonicProcessors.insert({"CZ", labelProc});
-    mnemonicProcessors.insert({"CNC", labelProc});
-    mnemonicProcessors.insert({"CC", labelProc});
-    mnemonicProcessors.insert({"CPO", labelProc});
-    mnemonicProcessors.insert({"CPE", labelProc});
-    mnemonicProcessors.insert({"CP", labelProc});
-    mnemonicProcessors.insert({"CM", labelProc});
-
-    mnemonicProcessors.insert({"ADD", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x80u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"ADC", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x88u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"SUB", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x90u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"SBB", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x98u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"ANA", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0xA0u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"XRA", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0xA8u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"ORA", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0xB0u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"CMP", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0xB8u | i.operand]; i.operand = 0;}});
-    mnemonicProcessors.insert({"INR", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x04u | (i.operand << 3)]; i.operand = 0;}});
-    mnemonicProcessors.insert({"DCR", [&](Instruction &i, const char *name) {singleRegisterProc(i, name); i.code = opcodesByCode[0x05u | (i.operand << 3)]; i.operand = 0;}});
-
-    mnemonicProcessors.insert({"MOV", [&](Instruction &i, const char *) { //Call this for the MOV instructions which are the only ones which take two 1-byte register names as an argument.
+    mnemonicProcessors[mnemonicId("JMP")] = labelProc;
+    mnemonicProcessors[mnemonicId("JNZ")] = labelProc;
+    mnemonicProcessors[mnemonicId("JZ")] = labelProc;
+    mnemonicProcessors[mnemonicId("JNC")] = labelProc;
+    mnemonicProcessors[mnemonicId("JC")] = labelProc;
+    mnemonicProcessors[mnemonicId("JPO")] = labelProc;
+    mnemonicProcessors[mnemonicId("JPE")] = labelProc;
+    mnemonicProcessors[mnemonicId("JP")] = labelProc;
+    mnemonicProcessors[mnemonicId("JM")] = labelProc;
+    mnemonicProcessors[mnemonicId("CALL")] = labelProc;
+    mnemonicProcessors[mnemonicId("CNZ")] = labelProc;
+    mnemonicProcessors[mnemonicId("CZ")] = labelProc;
+    mnemonicProcessors[mnemonicId("CNC")] = labelProc;
+    mnemonicProcessors[mnemonicId("CC")] = labelProc;
+    mnemonicProcessors[mnemonicId("CPO")] = labelProc;
+    mnemonicProcessors[mnemonicId("CPE")] = labelProc;
+    mnemonicProcessors[mnemonicId("CP")] = labelProc;
+    mnemonicProcessors[mnemonicId("CM")] = labelProc;
+
+    mnemonicProcessors[mnemonicId("ADD")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x80u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("ADC")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x88u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("SUB")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x90u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("SBB")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x98u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("ANA")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0xA0u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("XRA")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0xA8u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("ORA")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0xB0u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("CMP")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0xB8u | i.operand]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("INR")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x04u | (i.operand << 3)]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("DCR")] = [&](Instruction &i, mnemonic_t mnemonic) {singleRegisterProc(i, mnemonic); i.code = opcodesByCode[0x05u | (i.operand << 3)]; i.operand = 0;};
+
+    mnemonicProcessors[mnemonicId("MOV")] = [&](Instruction &i, mnemonic_t) { //Call this for the MOV instructions which are the only ones which take two 1-byte register names as an argument.
         ignoreWhitespaces(); data8_t code = 0x40u;
         if(!(tok.ttype == Tokenizer::IDENTIFIER && tok.token.length() == 1))
             throw SyntaxError(tok, "Expected a byte register name (B,C,D,E,H,L,M,A)");
@@ -321,20 +333,19 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
         }
         if(code == HLT) throw SyntaxError(tok, "Moving from M to M is not supported");
         i.code = opcodesByCode[code];
-    }});
+    };
 
-    mnemonicProcessors.insert({"LDAX", [&](Instruction &i, const char *name) {STAX_LDAX_Proc(i, name); i.code = opcodesByCode[0x0Au | (i.operand << 4)]; i.operand = 0;}});
-    mnemonicProcessors.insert({"STAX", [&](Instruction &i, const char *name) {STAX_LDAX_Proc(i, name); i.code = opcodesByCode[0x02u | (i.operand << 4)]; i.operand = 0;}});
+    mnemonicProcessors[mnemonicId("LDAX")] = [&](Instruction &i, mnemonic_t mnemonic) {STAX_LDAX_Proc(i, mnemonic); i.code = opcodesByCode[0x0Au | (i.operand << 4)]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("STAX")] = [&](Instruction &i, mnemonic_t mnemonic) {STAX_LDAX_Proc(i, mnemonic); i.code = opcodesByCode[0x02u | (i.operand << 4)]; i.operand = 0;};
 
-    mnemonicProcessors.insert({"INX", [&](Instruction &i, const char *name) {registerPairProc(i, name); i.code = opcodesByCode[0x03u | (i.operand << 4)]; i.operand = 0;}});
-    mnemonicProcessors.insert({"DCX", [&](Instruction &i, const char *name) {registerPairProc(i, name); i.code = opcodesByCode[0x0Bu | (i.operand << 4)]; i.operand = 0;}});
-    mnemonicProcessors.insert({"DAD", [&](Instruction &i, const char *name) {registerPairProc(i, name); i.code = opcodesByCode[0x09u | (i.operand << 4)]; i.operand = 0;}});
+    mnemonicProcessors[mnemonicId("INX")] = [&](Instruction &i, mnemonic_t mnemonic) {registerPairProc(i, mnemonic); i.code = opcodesByCode[0x03u | (i.operand << 4)]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("DCX")] = [&](Instruction &i, mnemonic_t mnemonic) {registerPairProc(i, mnemonic); i.code = opcodesByCode[0x0Bu | (i.operand << 4)]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("DAD")] = [&](Instruction &i, mnemonic_t mnemonic) {registerPairProc(i, mnemonic); i.code = opcodesByCode[0x09u | (i.operand << 4)]; i.operand = 0;};
 
-    mnemonicProcessors.insert({"LXI", [&](Instruction &i, const char *) { //Call for LXI that takes a single register pair (BC, DE, HL or SP) and a word integer as arguments.
-        static CaseInsensitive comparator;
+    mnemonicProcessors[mnemonicId("LXI")] = [&](Instruction &i, mnemonic_t) { //Call for LXI that takes a single register pair (BC, DE, HL or SP) and a word integer as arguments.
         ignoreWhitespaces(); data8_t code = 0x01u;
         if(tok.ttype != Tokenizer::IDENTIFIER) throw SyntaxError(tok, "Expected either B, D, H or SP");
-        if(!comparator(tok.token.c_str(), "SP") && !comparator("SP", tok.token.c_str())) code |= (3 << 4);
+        if(tok.token.equalsIgnoreCase("SP")) code |= (3 << 4);
         else if(tok.token.length() != 1) throw SyntaxError(tok, "Expected either B, D, H or SP");
         else switch(tok.token[0]) {
         case 'b': case 'B': code |= (0 << 4); break;
@@ -355,10 +366,10 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = (data16_t)(x & 0xFFFFu);
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFFFH or 65535");*/
-        i.operand = convertNumberWord(tok);
-    }});
+        parseOperand(i, false);
+    };
 
-    mnemonicProcessors.insert({"MVI", [&](Instruction &i, const char *) { //Call this for the MVI instructions which takes a 1-byte register name and a 1-byte integer (eg. 134 or 22H, etc.) as arguments.
+    mnemonicProcessors[mnemonicId("MVI")] = [&](Instruction &i, mnemonic_t) { //Call this for the MVI instructions which takes a 1-byte register name and a 1-byte integer (eg. 134 or 22H, etc.) as arguments.
         ignoreWhitespaces(); data8_t code = 0x06u;
         //Register names could be identified as a hex digit.
         if(!((tok.ttype == Tokenizer::IDENTIFIER || tok.ttype == Tokenizer::HEXNUMBER) && tok.token.length() == 1))
@@ -388,26 +399,26 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = x & 0xFFu;
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFH or 255");*/
-        i.operand = convertNumberByte(tok);
-    }});
+        parseOperand(i, true);
+    };
 
-    mnemonicProcessors.insert({"PUSH", [&](Instruction &i, const char *name) {stackProc(i, name); i.code = opcodesByCode[0xC5u | (i.operand << 4)]; i.operand = 0;}});
-    mnemonicProcessors.insert({"POP", [&](Instruction &i, const char *name) {stackProc(i, name); i.code = opcodesByCode[0xC1u | (i.operand << 4)]; i.operand = 0;}});
+    mnemonicProcessors[mnemonicId("PUSH")] = [&](Instruction &i, mnemonic_t mnemonic) {stackProc(i, mnemonic); i.code = opcodesByCode[0xC5u | (i.operand << 4)]; i.operand = 0;};
+    mnemonicProcessors[mnemonicId("POP")] = [&](Instruction &i, mnemonic_t mnemonic) {stackProc(i, mnemonic); i.code = opcodesByCode[0xC1u | (i.operand << 4)]; i.operand = 0;};
 
-    mnemonicProcessors.insert({"RST", [&](Instruction &i, const char *) { //Call for RST instructions which take an integer from 0 to 7 inclusive.
+    mnemonicProcessors[mnemonicId("RST")] = [&](Instruction &i, mnemonic_t) { //Call for RST instructions which take an integer from 0 to 7 inclusive.
         unsigned n;
         ignoreWhitespaces();
         //if(tok.ttype != Tokenizer::DECNUMBER) throw SyntaxError(tok, "Expected an integer between 0 to 7 inclusive");
         //std::sscanf(tok.token.c_str(), "%u%*[dD]", &n);
-        n = convertNumberByte(tok);
+        n = parseConstant(false);
         if(n > 7) throw SyntaxError(tok, "Expected an integer between 0 and 7 inclusive");
         i.code = opcodesByCode[0xC7u | (n << 3)];
-    }});
+    };
 
     //Format of ORG is this:
     // # ORG <16-bit address number>
     //Indicates the following instruction lines will be put starting from the given address.
-    pseudocodeProcessors.insert({"ORG", [&](Instruction &i, const char *) {//For #ORG pseudocode.
+    pseudocodeProcessors[mnemonicId("ORG")] = [&](Instruction &i, mnemonic_t) {//For #ORG pseudocode.
         i.code = &ORG;
         ignoreWhitespaces();
         /*if(tok.ttype == Tokenizer::DECNUMBER) {
@@ -421,16 +432,16 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = (data16_t)(x & 0xFFFFu);
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFFFH or 65535");*/
-        i.operand = convertNumberWord(tok);
+        parseOperand(i, false); //symbols in it must be defined before the #ORG line
         ignoreWhitespaces();
-    }});
+    };
 
     //Format for DATA is this:
     // # DATA <16-bit address>  <8-bit number> <8-bit number> <8-bit number> ...
     //The above statement ignores any #ORG statements. Example:
     // #DATA 2200H 12H, 23H, 2DH, 21H
     //puts byte 12H in address 2200H, 23H in 2201H, 2DH in 2202H, and 21H in 2202H.
-    pseudocodeProcessors.insert({"DATA", [&](Instruction &i, const char *) {
+    pseudocodeProcessors[mnemonicId("DATA")] = [&](Instruction &i, mnemonic_t) {
         i.code = &DATA;
         ignoreWhitespaces();
         //expect a 16-bit number to indicate target storing address
@@ -445,7 +456,9 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             i.operand = (data16_t)(x & 0xFFFFu);
         }
         else throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFFFH or 65535");*/
-        i.operand = convertNumberWord(tok);
+        i.operand = parseConstant(false);
+        //The data bytes are appended to the arena; the instruction only records where they start and how many there are
+        i.dataOffset = (uint_least32_t)arena->size();
         //Now we will parse a list of numbers
         while(true) {
             ignoreWhitespaces(); //advance
@@ -454,7 +467,8 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
                 /*std::sscanf(tok.token.c_str(), "%u%*[dD]", &x);
                 if(x > 255u) throw SyntaxError(tok, "Expected a nonnegative number less than or equal to 255 or FFH");
                 i.extraOperands.push_back(x & 0xFFu); break;*/
-                i.extraOperands.push_back(convertNumberByte(tok));
+                arena->push_back(convertNumberByte(tok)); i.dataLength++;
+                break;
             /*case Tokenizer::HEXNUMBER:
                 std::sscanf(tok.token.c_str(), "%x%*[hH]", &x);
                 if(x > 0xFFu) throw SyntaxError(tok, "Expected a nonnegative number less than or equal to FFH or 255");
@@ -467,12 +481,83 @@ LineTranslator::LineTranslator(Tokenizer &tok)  : tok(tok) {
             }
         }
     outOfLoop:
-        i.extraOperands.shrink_to_fit();
-    }});
+        return;
+    };
+
+    //Format of EQU and SET is this:
+    // <name> EQU <expression>
+    //Defines a symbol, like a label but with any value. EQU symbols are constants; SET symbols may be set again later.
+    const std::function<void(Instruction &, mnemonic_t)> symbolProc = [&](Instruction &i, mnemonic_t mnemonic) {
+        i.code = getOpcode(mnemonic);
+        ignoreWhitespaces();
+        parseOperand(i, false); //symbols in it must be defined above
+        ignoreWhitespaces();
+    };
+    pseudocodeProcessors[mnemonicId("EQU")] = symbolProc;
+    pseudocodeProcessors[mnemonicId("SET")] = symbolProc;
+
+    //Format of DB and DW is this:
+    // [<label>:] DB <item>, <item>, ...
+    //Puts the items at the current address, like instructions. DB items are bytes or strings ("text" or 'text'); DW items are
+    //words, stored low byte first. Items may be expressions; those which use symbols or $ are filled in during assembly.
+    const std::function<void(Instruction &, mnemonic_t)> dataListProc = [&](Instruction &i, mnemonic_t mnemonic) {
+        i.code = getOpcode(mnemonic);
+        const bool isByte = i.code == &DB;
+        i.dataOffset = (uint_least32_t)arena->size();
+        ignoreWhitespaces();
+        while(true) {
+            if(tok.ttype == Tokenizer::STRING && !isCharacterConstant()) {
+                if(!isByte) throw SyntaxError(tok, "Strings are only allowed with DB");
+                arena->insert(arena->end(), tok.token.data + 1, tok.token.data + tok.token.size - 1u);
+            } else {
+                const Tokenizer start = tok;
+                const uint_least32_t offset = (uint_least32_t)(arena->size() - i.dataOffset);
+                data16_t value;
+                if(!parseExpression(value)) {
+                    //Deferred item: where it goes in the data, followed by the expression. The list ends with an empty one.
+                    if(i.expression == 0u) i.expression = (uint_least32_t)expressions->size() + 1u;
+                    expressions->push_back(ExprItem{ExprItem::AT, offset});
+                    expressions->insert(expressions->end(), postfix.begin(), postfix.end());
+                    value = 0u;
+                }
+                else if(isByte && !fitsInByte(value)) throw SyntaxError(start, "Expected a number between -128 and 255 (FFH)");
+                arena->push_back((data8_t)(value & 0xFFu));
+                if(!isByte) arena->push_back((data8_t)((value >> 8) & 0xFFu));
+            }
+            ignoreWhitespaces();
+            if(!(tok.ttype == Tokenizer::SEPARATOR && tok.token[0] == ',')) break;
+            ignoreWhitespaces();
+        }
+        if(i.expression != 0u) expressions->push_back(ExprItem{ExprItem::END, 0u});
+        i.dataLength = (uint_least32_t)(arena->size() - i.dataOffset);
+        if(i.dataLength > MEMORY_SIZE) throw SyntaxError(tok, "Too much data for the address space");
+    };
+    pseudocodeProcessors[mnemonicId("DB")] = dataListProc;
+    pseudocodeProcessors[mnemonicId("DW")] = dataListProc;
+
+    //Format of DS is this:
+    // [<label>:] DS <number of bytes>
+    //Reserves address space at the current address. Nothing is written there, so the memory keeps whatever it holds.
+    pseudocodeProcessors[mnemonicId("DS")] = [&](Instruction &i, mnemonic_t) {
+        i.code = &DS;
+        ignoreWhitespaces();
+        parseOperand(i, false); //symbols in it must be defined above
+        ignoreWhitespaces();
+    };
+
+    //Format of INCBIN is this:
+    // [<label>:] INCBIN "<file>"
+    //Puts the bytes of a binary file at the current address, like DB. The file itself is read during assembly, not here.
+    pseudocodeProcessors[mnemonicId("INCBIN")] = [&](Instruction &i, mnemonic_t) {
+        i.code = &INCBIN;
+        ignoreWhitespaces();
+        if(tok.ttype != Tokenizer::STRING || tok.token.size < 3u) throw SyntaxError(tok, "Expected a file name in quotes");
+        i.toLabel = pool->intern(tok.token.data + 1, tok.token.size - 2u);
+        ignoreWhitespaces();
+    };
 }
 Instruction LineTranslator::translateOneLine() {
     Instruction i; i.lineNumber = tok.lineNumber;
-    std::string name; //temporary
     ignoreWhitespaces();
     //if we have a comment or a newline or eof; we skip to the end. This is an empty line.
     if(tok.ttype == Tokenizer::COMMENT || tok.ttype == Tokenizer::NEWLINE || tok.ttype == Tokenizer::END_OF_FILE)
@@ -484,29 +569,42 @@ Instruction LineTranslator::translateOneLine() {
         ignoreWhitespaces();
         //There should be pseudocode here
         if(tok.ttype != Tokenizer::PSEUDOCODE) throw SyntaxError(tok, "Expected pseudocode");
-        name = std::string(tok.token); //copy name
-        pseudocodeProcessors[name.c_str()](i, name.c_str()); //This initializes i.code, i.operand and i.extraOperands (if needed)
+        if(!pseudocodeProcessors[tok.mnemonic]) throw SyntaxError(tok, "Unexpected directive"); //MACRO, IF etc. in the wrong place
+        pseudocodeProcessors[tok.mnemonic](i, tok.mnemonic); //This initializes i.code, i.operand and the data span (if needed)
         goto translationEnd;
     }
     //Lines beginning with any other alphanumeric sequence (identifiers) may indicate labels
     if(tok.ttype == Tokenizer::IDENTIFIER) {
         //Identifiers at the start to indicate labels. Make sure it's a label
-        i.label = std::string(tok.token); //force copy
+        i.label = pool->intern(tok.token.data, tok.token.size); //copied into the pool, the source buffer may go away
         ignoreWhitespaces();
-        //Now we should have : separator.
-        if(!(tok.ttype == Tokenizer::SEPARATOR && tok.token[0] == ':'))
+        //Now we should have : separator (optional before EQU and SET, as in "SIZE EQU 10").
+        const bool colon = tok.ttype == Tokenizer::SEPARATOR && tok.token[0] == ':';
+        if(colon) ignoreWhitespaces(); //go to next token, hopefully an opcode mnemonic.
+        //The # of a pseudocode may follow the label too, as in "TBL: # DB 1,2" or "K # EQU 5".
+        if(tok.ttype == Tokenizer::SEPARATOR && tok.token[0] == '#') {
+            ignoreWhitespaces();
+            if(tok.ttype != Tokenizer::PSEUDOCODE) throw SyntaxError(tok, "Expected pseudocode");
+        }
+        if(!colon && !(tok.ttype == Tokenizer::PSEUDOCODE && (getOpcode(tok.mnemonic) == &EQU || getOpcode(tok.mnemonic) == &SET)))
             throw SyntaxError(tok, "Expected \':\'");
-        ignoreWhitespaces(); //go to next token, hopefully an opcode mnemonic.
     }
     //Now we will get an opcode mnemonic.
     if(tok.ttype == Tokenizer::OPCODE) {
         //We would need to translate the rest of the line according to the mnemonic given.
-        name = std::string(tok.token); //copy name
-        mnemonicProcessors[name.c_str()](i, name.c_str()); //This initializes i.code and i.operand.
+        mnemonicProcessors[tok.mnemonic](i, tok.mnemonic); //This initializes i.code and i.operand.
         ignoreWhitespaces(); //advance to end of line
     }
+    //Pseudocodes may also be written without the #.
+    else if(tok.ttype == Tokenizer::PSEUDOCODE) {
+        if(!pseudocodeProcessors[tok.mnemonic]) throw SyntaxError(tok, "Unexpected directive");
+        pseudocodeProcessors[tok.mnemonic](i, tok.mnemonic);
+    }
     else throw SyntaxError(tok, "Expected opcode mnemonic");
 translationEnd:
+    //EQU and SET define the label; DB, DW and DS may have one; ORG and DATA put nothing at the current address to label.
+    if(i.label == 0u && (i.code == &EQU || i.code == &SET)) throw SyntaxError(tok, "Expected a name before EQU or SET");
+    if(i.label != 0u && (i.code == &ORG || i.code == &DATA)) throw SyntaxError(tok, "A label is not allowed here");
     //At the end we can have a comment.
     if(tok.ttype == Tokenizer::COMMENT || tok.ttype == Tokenizer::WHITESPACE) ignoreWhitespaces();
     //Instructions must be terminated by newline or EOF.
@@ -514,7 +612,7 @@ translationEnd:
         throw SyntaxError(tok, "Expected end of line or end of file");
     return i;
 }
-void LineTranslator::singleRegisterProc(Instruction &i, const char *) {
+void LineTranslator::singleRegisterProc(Instruction &i, mnemonic_t) {
     ignoreWhitespaces();
     if(!(tok.ttype == Tokenizer::IDENTIFIER && tok.token.length() == 1))
         throw SyntaxError(tok, "Expected a byte register name (B,C,D,E,H,L,M,A)");
@@ -530,7 +628,7 @@ void LineTranslator::singleRegisterProc(Instruction &i, const char *) {
     default: throw SyntaxError(tok, "Expected a byte register name (B,C,D,E,H,L,M,A)");
     }
 }
-void LineTranslator::STAX_LDAX_Proc(Instruction &i, const char *) {
+void LineTranslator::STAX_LDAX_Proc(Instruction &i, mnemonic_t) {
     ignoreWhitespaces();
     if(!(tok.ttype == Tokenizer::IDENTIFIER && tok.token.length() == 1))
         throw SyntaxError(tok, "Expected either B or D");
@@ -540,10 +638,10 @@ void LineTranslator::STAX_LDAX_Proc(Instruction &i, const char *) {
     default: throw SyntaxError(tok, "Expected either B or D");
     }
 }
-void LineTranslator::registerPairProc(Instruction &i, const char *) {
+void LineTranslator::registerPairProc(Instruction &i, mnemonic_t) {
     ignoreWhitespaces();
     if(tok.ttype != Tokenizer::IDENTIFIER) throw SyntaxError(tok, "Expected either B, D, H or SP");
-    if(!CaseInsensitive::comparator(tok.token.c_str(), "SP") && !CaseInsensitive::comparator("SP", tok.token.c_str())) i.operand = 3;
+    if(tok.token.equalsIgnoreCase("SP")) i.operand = 3;
     else if(tok.token.length() != 1) throw SyntaxError(tok, "Expected either B, D, H or SP");
     else switch(tok.token[0]) {
     case 'b': case 'B': i.operand = 0; break;
@@ -551,10 +649,10 @@ void LineTranslator::registerPairProc(Instruction &i, const char *) {
     case 'h': case 'H': i.operand = 2; break;
     }
 }
-void LineTranslator::stackProc(Instruction &i, const char *) {
+void LineTranslator::stackProc(Instruction &i, mnemonic_t) {
     ignoreWhitespaces();
     if(tok.ttype != Tokenizer::IDENTIFIER) throw SyntaxError(tok, "Expected either B, D, H or PSW");
-    if(!CaseInsensitive::comparator(tok.token.c_str(), "PSW") && !CaseInsensitive::comparator("PSW", tok.token.c_str())) i.operand = 3;
+    if(tok.token.equalsIgnoreCase("PSW")) i.operand = 3;
     else if(tok.token.length() != 1) throw SyntaxError(tok, "Expected either B, D, H or PSW");
     else switch(tok.token[0]) {
     case 'b': case 'B': i.operand = 0; break;
@@ -563,71 +661,808 @@ void LineTranslator::stackProc(Instruction &i, const char *) {
     }
 }
 
-//Assembler
+//Operand expressions
+
+void LineTranslator::append(ExprItem::Op op, uint_least32_t value) {
+    switch(op) {
+    case ExprItem::NUMBER: case ExprItem::SYMBOL: case ExprItem::HERE:
+        if(++depth > EXPR_STACK_SIZE) throw SyntaxError(tok, "Expression too complex");
+        break;
+    case ExprItem::NEG: case ExprItem::HIGH: case ExprItem::LOW: case ExprItem::NOT: break;
+    default: depth--; break;
+    }
+    postfix.push_back(ExprItem{op, value});
+}
+int LineTranslator::binaryOperator(ExprItem::Op &op) const {
+    if(tok.ttype == Tokenizer::OPERATOR) switch(tok.token[0]) {
+    case '+': op = ExprItem::ADD; return 4;
+    case '-': op = ExprItem::SUB; return 4;
+    case '*': op = ExprItem::MUL; return 5;
+    case '/': op = ExprItem::DIV; return 5;
+    default: return 0;
+    }
+    if(tok.ttype != Tokenizer::IDENTIFIER) return 0;
+    static const struct {const char *name; ExprItem::Op op; int precedence;} words[] = {
+        {"MOD", ExprItem::MOD, 5}, {"SHL", ExprItem::SHL, 5}, {"SHR", ExprItem::SHR, 5},
+        {"EQ", ExprItem::EQ, 3}, {"NE", ExprItem::NE, 3}, {"LT", ExprItem::LT, 3},
+        {"GT", ExprItem::GT, 3}, {"LE", ExprItem::LE, 3}, {"GE", ExprItem::GE, 3},
+        {"AND", ExprItem::AND, 2}, {"OR", ExprItem::OR, 1}
+    };
+    for(const auto &word : words) if(tok.token.equalsIgnoreCase(word.name)) {op = word.op; return word.precedence;}
+    return 0;
+}
+void LineTranslator::parseBinary(int minPrecedence) {
+    parseUnary();
+    ExprItem::Op op; int precedence;
+    while((precedence = binaryOperator(op)) >= minPrecedence) {
+        nextToken();
+        parseBinary(precedence + 1); //left associative
+        append(op);
+    }
+}
+void LineTranslator::parseUnary() {
+    ExprItem::Op op;
+    if(tok.ttype == Tokenizer::OPERATOR && (tok.token[0] == '-' || tok.token[0] == '+'))
+        op = tok.token[0] == '-' ? ExprItem::NEG : ExprItem::END;
+    else if(tok.ttype == Tokenizer::IDENTIFIER && tok.token.equalsIgnoreCase("HIGH")) op = ExprItem::HIGH;
+    else if(tok.ttype == Tokenizer::IDENTIFIER && tok.token.equalsIgnoreCase("LOW")) op = ExprItem::LOW;
+    else if(tok.ttype == Tokenizer::IDENTIFIER && tok.token.equalsIgnoreCase("NOT")) op = ExprItem::NOT;
+    else {parsePrimary(); return;}
+    if(++nesting > EXPR_STACK_SIZE) throw SyntaxError(tok, "Expression too complex");
+    nextToken(); parseUnary();
+    if(op != ExprItem::END) append(op); //unary + does nothing
+    nesting--;
+}
+void LineTranslator::parsePrimary() {
+    switch(tok.ttype) {
+    case Tokenizer::DECNUMBER: case Tokenizer::OCTNUMBER: case Tokenizer::HEXNUMBER: case Tokenizer::BINNUMBER:
+        append(ExprItem::NUMBER, convertNumberWord(tok)); break;
+    case Tokenizer::IDENTIFIER: append(ExprItem::SYMBOL, pool->intern(tok.token.data, tok.token.size)); break;
+    case Tokenizer::STRING:
+        if(!isCharacterConstant()) throw SyntaxError(tok, "Expected a single character in quotes");
+        append(ExprItem::NUMBER, (unsigned char)tok.token[1]); break;
+    case Tokenizer::OPERATOR:
+        if(tok.token[0] == '$') {append(ExprItem::HERE); break;}
+        if(tok.token[0] == '(') {
+            if(++nesting > EXPR_STACK_SIZE) throw SyntaxError(tok, "Expression too complex");
+            nextToken(); parseBinary(1);
+            if(!(tok.ttype == Tokenizer::OPERATOR && tok.token[0] == ')')) throw SyntaxError(tok, "Expected \')\'");
+            nesting--; break;
+        }
+        //fall through
+    default: throw SyntaxError(tok, "Expected a number, a label, $ or \'(\'");
+    }
+    nextToken();
+}
+bool LineTranslator::parseExpression(data16_t &value) {
+    postfix.clear(); depth = 0u; nesting = 0u;
+    parseBinary(1);
+    tok = lastToken; //the caller expects to be at the last token of the operand, as with a single number token
+    postfix.push_back(ExprItem{ExprItem::END, 0u});
+    for(const ExprItem &item : postfix) if(item.op == ExprItem::SYMBOL || item.op == ExprItem::HERE) return false;
+    string_id_t undefined;
+    if(evaluateExpression(postfix.data(), 0u, SymbolLookup(), value, undefined) != EXPR_OK)
+        throw SyntaxError(tok, "Division by zero");
+    return true;
+}
+void LineTranslator::parseOperand(Instruction &i, bool isByte) {
+    const Tokenizer start = tok;
+    data16_t value;
+    if(parseExpression(value)) {
+        if(isByte && !fitsInByte(value)) throw SyntaxError(start, "Expected a number between -128 and 255 (FFH)");
+        i.operand = isByte ? (value & 0xFFu) : value;
+        return;
+    }
+    //Depends on symbols or $: keep it for the assembler, along with its text for display.
+    i.expression = (uint_least32_t)expressions->size() + 1u;
+    expressions->insert(expressions->end(), postfix.begin(), postfix.end());
+    i.toLabel = pool->intern(start.token.data, (size_t)(tok.token.data + tok.token.size - start.token.data));
+}
+const ExprItem *LineTranslator::translateExpression(data16_t &value) {
+    ignoreWhitespaces();
+    const bool constant = parseExpression(value);
+    ignoreWhitespaces();
+    if(tok.ttype == Tokenizer::COMMENT) ignoreWhitespaces();
+    if(tok.ttype != Tokenizer::END_OF_FILE && tok.ttype != Tokenizer::NEWLINE)
+        throw SyntaxError(tok, "Expected end of line or end of file");
+    return constant ? nullptr : postfix.data();
+}
+data16_t LineTranslator::parseConstant(bool isByte) {
+    const Tokenizer start = tok;
+    data16_t value;
+    if(!parseExpression(value)) throw SyntaxError(start, "Expected a constant expression (no labels or $)");
+    if(isByte && !fitsInByte(value)) throw SyntaxError(start, "Expected a number between -128 and 255 (FFH)");
+    return isByte ? (value & 0xFFu) : value;
+}
 
-Assembler::Assembler(Processor *proc) : QObject(proc), processor(proc), in(nullptr) {
+//Preprocessor
+
+Preprocessor::Preprocessor() : source(nullptr), sourceLength(0u), position(0u), lineNumber(1u), collecting(nullptr), nesting(0u),
+    collectedStart(), collectedRepetitions(0u), scan(nullptr, 0u), operands(0u) {}
+void Preprocessor::reset(const char *source, size_t length) {
+    this->source = source; sourceLength = length; position = 0u; lineNumber = 1u;
+    macros.clear(); frames.clear(); conditions.clear();
+    collecting = nullptr; collected.reset();
+}
+bool Preprocessor::readLine(SourceLine &line) {
+    while(!frames.empty()) {
+        Frame &frame = frames.back();
+        if(frame.next < frame.block->lines.size()) {
+            const std::string &text = frame.block->lines[frame.next++];
+            line = SourceLine{text.data(), text.length(), frame.lineNumber, frame.offset, true, nullptr, 0u};
+            if(!frame.block->file.empty()) {line.file = frame.block->file.c_str(); line.fileLineNumber = (unsigned)frame.next;}
+            if(frame.block->params.empty()) return true;
+            //Replace every word which names a parameter by its value.
+            buffer.clear();
+            scan.reset(text.data(), text.length());
+            size_t copied = 0u;
+            while(scan.getNextToken() != Tokenizer::END_OF_FILE) {
+                if(scan.ttype == Tokenizer::CHAR_ERROR) {scan.getNextChar(); continue;} //left as it is
+                if(!std::isalpha((unsigned char)scan.token[0])) continue;
+                for(size_t k = 0; k < frame.block->params.size(); k++) if(scan.token.equalsIgnoreCase(frame.block->params[k].c_str())) {
+                    buffer.append(text, copied, scan.token.offset - copied).append(frame.args[k]);
+                    copied = scan.token.offset + scan.token.size;
+                    break;
+                }
+            }
+            buffer.append(text, copied, std::string::npos);
+            line.text = buffer.data(); line.length = buffer.length();
+            return true;
+        }
+        if(++frame.repetition < frame.repetitions) {
+            frame.next = 0u;
+            if(!frame.values.empty()) frame.args[0] = frame.values[frame.repetition];
+            continue;
+        }
+        //IFs must end in the block they started in.
+        while(!conditions.empty() && conditions.back().frame == frames.size()) {
+            const Condition &open = conditions.back();
+            report(SourceLine{"", 0u, open.lineNumber, open.offset, true, nullptr, 0u}.error(0u, 0, "IF without ENDIF"));
+            conditions.pop_back();
+        }
+        frames.pop_back();
+    }
+    if(position > sourceLength) return false;
+    const void *const newline = std::memchr(source + position, '\n', sourceLength - position);
+    const size_t end = newline != nullptr ? (size_t)((const char *)newline - source) : sourceLength;
+    line = SourceLine{source + position, end - position, lineNumber++, position, false, nullptr, 0u};
+    position = end + 1u;
+    return true;
+}
+std::shared_ptr<const Preprocessor::Block> Preprocessor::findMacro(const TokenView &name) {
+    if(macros.empty()) return nullptr;
+    key.resize(name.size);
+    for(size_t k = 0; k < name.size; k++) key[k] = (char)std::toupper((unsigned char)name[k]);
+    const std::unordered_map<std::string, std::shared_ptr<const Block>>::const_iterator it = macros.find(key);
+    return it != macros.end() ? it->second : nullptr;
+}
+const opcode *Preprocessor::classify(const SourceLine &line) {
+    invoked.reset(); name = label = TokenView();
+    scan.reset(line.text, line.length);
+    skipWhitespaces();
+    if(scan.ttype == Tokenizer::SEPARATOR && scan.token[0] == '#') skipWhitespaces();
+    if(scan.ttype == Tokenizer::IDENTIFIER) {
+        const TokenView first = scan.token;
+        skipWhitespaces();
+        if(scan.ttype == Tokenizer::SEPARATOR && scan.token[0] == ':') {label = first; skipWhitespaces();}
+        else if(scan.ttype == Tokenizer::PSEUDOCODE && getOpcode(scan.mnemonic) == &MACRO) label = first; //"NAME MACRO"
+        else if((invoked = findMacro(first)) != nullptr) {name = first; operands = first.offset + first.size; return nullptr;}
+        else return nullptr;
+    }
+    if(!label.empty() && scan.ttype == Tokenizer::IDENTIFIER && (invoked = findMacro(scan.token)) != nullptr) {
+        name = scan.token; operands = scan.token.offset + scan.token.size; return nullptr;
+    }
+    if(scan.ttype != Tokenizer::PSEUDOCODE) return nullptr;
+    const opcode *const code = getOpcode(scan.mnemonic);
+    if(code != &MACRO && code != &ENDM && code != &REPT && code != &IRP && code != &IF && code != &ELSE && code != &ENDIF &&
+       code != &INCLUDE) return nullptr;
+    if(code == &MACRO) {
+        if(label.empty()) error(line, "Expected a name before MACRO");
+        name = label; label = TokenView();
+    }
+    else if(!label.empty()) {error(line, "A label is not allowed here"); label = TokenView();}
+    operands = scan.position;
+    return code;
+}
+void Preprocessor::splitArguments(const char *text, size_t length, std::vector<std::string> &values) {
+    values.clear();
+    size_t start = 0u, k = 0u; int depth = 0; char quote = '\0';
+    const auto push = [&](size_t end) {
+        while(start < end && std::isspace((unsigned char)text[start])) start++;
+        while(end > start && std::isspace((unsigned char)text[end-1u])) end--;
+        if(end - start >= 2u && text[start] == '<' && text[end-1u] == '>') {start++; end--;}
+        values.emplace_back(text + start, end - start);
+    };
+    for(; k < length; k++) {
+        const char ch = text[k];
+        if(quote != '\0') {if(ch == quote) quote = '\0'; continue;}
+        if(ch == ';') break;
+        switch(ch) {
+        case '\'': case '"': quote = ch; break;
+        case '(': case '<': depth++; break;
+        case ')': case '>': if(depth > 0) depth--; break;
+        case ',': if(depth == 0) {push(k); start = k + 1u;} break;
+        default: break;
+        }
+    }
+    push(k);
+    if(values.size() == 1u && values[0].empty()) values.clear(); //no arguments at all
+}
+bool Preprocessor::expand(const std::shared_ptr<const Block> &block, const SourceLine &line, std::vector<std::string> &&args,
+                          std::vector<std::string> &&values, size_t repetitions) {
+    if(frames.size() >= MAX_NESTING) {
+        report(line.error(0u, 0, "Macro expansions or included files nested too deeply"));
+        //Most likely a macro which invokes itself: give up the expansion altogether (going on with the other frames could take
+        //forever), along with the IFs opened in it.
+        frames.clear();
+        while(!conditions.empty() && conditions.back().frame != 0u) conditions.pop_back();
+        return false;
+    }
+    if(repetitions == 0u || block->lines.empty()) return true;
+    frames.push_back(Frame{block, 0u, std::move(args), std::move(values), 0u, repetitions, line.lineNumber, line.offset});
+    return true;
+}
+std::shared_ptr<const Preprocessor::Block> Preprocessor::includeFile(const SourceLine &line) {
+    if(scan.ttype != Tokenizer::STRING || scan.token.size < 3u) {error(line, "Expected a file name in quotes"); return nullptr;}
+    const std::string name(scan.token.data + 1, scan.token.size - 2u);
+    //Relative paths are taken from the current directory (the directory of the opened source file).
+    const QFileInfo info(QString::fromStdString(name));
+    if(!info.isFile()) {error(line, "File " + name + " not found"); return nullptr;}
+    IncludedFile &cached = files[info.absoluteFilePath().toStdString()];
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    if(cached.block != nullptr && cached.modified == modified && cached.size == info.size()) return cached.block;
+    QFile file(info.absoluteFilePath());
+    if(!file.open(QIODevice::ReadOnly)) {error(line, "Cannot read file " + name); return nullptr;}
+    const QByteArray contents = file.readAll();
+    const std::shared_ptr<Block> block = std::make_shared<Block>();
+    block->file = name;
+    const char *const text = contents.constData(); const size_t length = (size_t)contents.size();
+    for(size_t start = 0; start <= length;) {
+        const void *const newline = std::memchr(text + start, '\n', length - start);
+        size_t end = newline != nullptr ? (size_t)((const char *)newline - text) : length;
+        const size_t next = end + 1u;
+        if(end > start && text[end-1u] == '\r') end--; //files written on Windows
+        block->lines.emplace_back(text + start, end - start);
+        start = next;
+    }
+    cached.modified = modified; cached.size = info.size(); cached.block = block;
+    return block;
+}
+void Preprocessor::condition(const opcode *code, const SourceLine &line) {
+    const bool active = conditions.empty() || conditions.back().active;
+    if(code == &IF) {
+        //Inside a skipped branch the whole IF is skipped, and its expression (which may well be invalid there) is ignored. So is
+        //an IF whose expression is in error, ELSE branch included.
+        data16_t value = 0u;
+        const bool evaluated = active && evaluate(line, operands, value);
+        const bool taken = evaluated && value != 0u;
+        conditions.push_back(Condition{taken, taken || !evaluated, active, false, frames.size(), line.lineNumber, line.offset});
+        return;
+    }
+    if(conditions.empty() || conditions.back().frame != frames.size()) {
+        error(line, code == &ELSE ? "ELSE without IF" : "ENDIF without IF");
+        return;
+    }
+    Condition &open = conditions.back();
+    if(code == &ENDIF) {conditions.pop_back(); return;}
+    if(open.sawElse) {error(line, "ELSE without IF"); return;}
+    open.active = open.parentActive && !open.taken;
+    open.taken = open.sawElse = true;
+}
+void Preprocessor::directive(const opcode *code, const SourceLine &line) {
+    if(code == &ENDM) {error(line, "ENDM without MACRO"); return;}
+    if(code == &INCLUDE) {
+        skipWhitespaces();
+        const std::shared_ptr<const Block> block = includeFile(line);
+        if(block == nullptr) return;
+        skipWhitespaces();
+        if(scan.ttype != Tokenizer::END_OF_FILE && scan.ttype != Tokenizer::COMMENT) {error(line, "Expected end of line or end of file"); return;}
+        expand(block, line, std::vector<std::string>(), std::vector<std::string>(), 1u);
+        return;
+    }
+    //Start reading a block; its lines are kept until the matching ENDM. A block whose directive is in error is still read (so
+    //that its ENDM matches), but never expanded.
+    collected = std::make_shared<Block>();
+    collectedStart = line; collectedStart.text = ""; collectedStart.length = 0u;
+    collectedValues.clear(); collectedRepetitions = 1u;
+    collecting = code; nesting = 1u;
+    if(code == &MACRO) {
+        collectedName.resize(name.size);
+        for(size_t k = 0; k < name.size; k++) collectedName[k] = (char)std::toupper((unsigned char)name[k]);
+        //Parameters: words separated by commas.
+        skipWhitespaces();
+        while(scan.ttype != Tokenizer::END_OF_FILE && scan.ttype != Tokenizer::COMMENT) {
+            if(!(scan.token.size > 0u && std::isalpha((unsigned char)scan.token[0]))) {
+                error(line, "Expected a parameter name");
+                collectedName.clear(); break;
+            }
+            collected->params.push_back(scan.token.str());
+            skipWhitespaces();
+            if(scan.ttype == Tokenizer::SEPARATOR && scan.token[0] == ',') skipWhitespaces();
+        }
+    }
+    else if(code == &REPT) {
+        data16_t value = 0u;
+        if(!evaluate(line, operands, value)) value = 0u; //no repetitions if in error
+        collectedRepetitions = value;
+    }
+    else { //IRP parameter, <value, value, ...>
+        collectedRepetitions = 0u;
+        skipWhitespaces();
+        if(!(scan.token.size > 0u && std::isalpha((unsigned char)scan.token[0]))) {error(line, "Expected a parameter name"); return;}
+        collected->params.push_back(scan.token.str());
+        skipWhitespaces();
+        if(!(scan.ttype == Tokenizer::SEPARATOR && scan.token[0] == ',')) {error(line, "Expected \',\'"); return;}
+        const char *const list = line.text + scan.position; const size_t listLength = line.length - scan.position;
+        splitArguments(list, listLength, collectedValues);
+        //A single <...> item is the list itself.
+        size_t k = 0u;
+        while(k < listLength && std::isspace((unsigned char)list[k])) k++;
+        if(collectedValues.size() == 1u && k < listLength && list[k] == '<') {
+            const std::string inner = collectedValues[0];
+            splitArguments(inner.data(), inner.length(), collectedValues);
+        }
+        collectedRepetitions = collectedValues.size();
+    }
+}
+bool Preprocessor::nextLine(SourceLine &line) {
+    while(readLine(line)) {
+        const opcode *const code = classify(line);
+        if(collecting != nullptr) {
+            if(consumed) consumed(line);
+            if(code == &MACRO || code == &REPT || code == &IRP) nesting++;
+            else if(code == &ENDM && --nesting == 0u) {
+                const opcode *const kind = collecting; collecting = nullptr;
+                if(kind == &MACRO) {if(!collectedName.empty()) macros[collectedName] = collected;}
+                else {
+                    std::vector<std::string> args;
+                    if(kind == &IRP) args.push_back(collectedValues.empty() ? std::string() : collectedValues[0]);
+                    expand(collected, collectedStart, std::move(args), std::move(collectedValues), collectedRepetitions);
+                }
+                collected.reset();
+                continue;
+            }
+            collected->lines.emplace_back(line.text, line.length);
+            continue;
+        }
+        if(code == &IF || code == &ELSE || code == &ENDIF) {condition(code, line); if(consumed) consumed(line); continue;}
+        if(!(conditions.empty() || conditions.back().active)) {if(consumed) consumed(line); continue;} //skipped branch
+        if(code != nullptr) {
+            //Listed first: the directive may start an expansion or change the line.
+            if(consumed) consumed(line);
+            directive(code, line); continue;
+        }
+        if(invoked == nullptr) return true;
+        //Macro invocation: the arguments are the rest of the line.
+        std::vector<std::string> args;
+        splitArguments(line.text + operands, line.length - operands, args);
+        if(args.size() > invoked->params.size()) report(line.error(0u, 0, "Too many arguments for macro " + name.str()));
+        args.resize(invoked->params.size());
+        if(consumed) consumed(line);
+        const TokenView labelText = label;
+        if(!expand(invoked, line, std::move(args), std::vector<std::string>(), 1u) || labelText.empty()) continue;
+        //A label on the invocation labels the address where the expansion starts.
+        buffer.assign(labelText.data, labelText.size).append(": DS 0");
+        line.text = buffer.data(); line.length = buffer.length(); line.expanded = true;
+        return true;
+    }
+    if(collecting != nullptr) {
+        report(collectedStart.error(0u, 0, "MACRO, REPT or IRP without ENDM"));
+        collecting = nullptr; collected.reset();
+    }
+    for(const Condition &open : conditions)
+        report(SourceLine{"", 0u, open.lineNumber, open.offset, false, nullptr, 0u}.error(0u, 0, "IF without ENDIF"));
+    conditions.clear();
+    return false;
+}
+
+//BasicAssembler
+
+BasicAssembler::BasicAssembler() : generation(0u), pool(std::make_shared<StringPool>()), lineTokenizer(nullptr, 0u),
+    translator(lineTokenizer, pool.get(), &arena, &expressions), owner(MEMORY_SIZE, 0u), object(nullptr), listing(nullptr),
+    diagnostics(nullptr), image(MEMORY_SIZE, 0u) {
     pseudocodeProcessors.insert({&ORG, [&](Instruction &i, memaddr_t &targetOffset) {targetOffset = i.operand & 0xFFFFu;}});
-    pseudocodeProcessors.insert({&DATA, [&](Instruction &i, memaddr_t &) {processor->overwrite(i.extraOperands.data(), i.operand & 0xFFFFu, i.extraOperands.size());}});
+    pseudocodeProcessors.insert({&DATA, [&](Instruction &i, memaddr_t &) {
+        for(size_t k = 0; k < i.dataLength; k++) image[(i.operand + k) & 0xFFFFu] = arena[i.dataOffset + k];
+    }});
+    const std::function<void(Instruction &, memaddr_t &)> dataListProc = [&](Instruction &i, memaddr_t &) {
+        for(size_t k = 0; k < i.dataLength; k++) image[(i.address + k) & 0xFFFFu] = arena[i.dataOffset + k];
+    };
+    pseudocodeProcessors.insert({&DB, dataListProc});
+    pseudocodeProcessors.insert({&DW, dataListProc});
+    pseudocodeProcessors.insert({&DS, [&](Instruction &i, memaddr_t &) {
+        //Nothing goes into the image; commit() leaves these bytes alone.
+        const memsize_t end = (memsize_t)i.address + i.operand;
+        reserved.push_back({i.address, std::min(end, MEMORY_SIZE)});
+        if(end > MEMORY_SIZE) reserved.push_back({0u, end - MEMORY_SIZE}); //wrapped around
+    }});
+    pseudocodeProcessors.insert({&INCBIN, [&](Instruction &, memaddr_t &) {}}); //copied by includeBinary() already
+}
+bool BasicAssembler::translateLine(const SourceLine &line, Instruction &i) {
+    const char *const text = line.text; const size_t length = line.length;
+    uint_fast64_t hash = 0xCBF29CE484222325ull; //FNV-1a
+    for(size_t k = 0; k < length; k++) {hash ^= (unsigned char)text[k]; hash *= 0x100000001B3ull;}
+    CachedLine &entry = lineCache[hash];
+    if(entry.generation == 0u || entry.text.length() != length || entry.text.compare(0, length, text, length) != 0) {
+        //New or edited line (or a hash collision, in which case the old entry is simply replaced).
+        entry.text.assign(text, length); entry.error.clear();
+        lineTokenizer.reset(text, length);
+        try {entry.instruction = translator.translateOneLine();} catch (SyntaxError const &ex) {
+            entry.instruction = Instruction(); entry.error = ex.what;
+            entry.errorColumn = ex.columnNumber; entry.errorPosition = ex.position;
+        }
+    }
+    entry.generation = generation;
+    if(!entry.error.empty()) {report(line.error(entry.errorColumn, entry.errorPosition, entry.error)); return false;}
+    i = entry.instruction; i.lineNumber = line.lineNumber;
+    return true;
+}
+void BasicAssembler::clearCache() {
+    //Cached instructions refer into the pool and the arenas, so they all go together. The old pool stays alive for as long
+    //as a model still holds on to it.
+    lineCache.clear(); arena.clear(); expressions.clear();
+    pool = std::make_shared<StringPool>(); translator.pool = pool.get();
 }
 #include <algorithm>
-#include <QCoreApplication>
 #include <unordered_map>
-void Assembler::doAssembly() {
-    Tokenizer tok(*in); LineTranslator translator(tok);
+bool BasicAssembler::doAssembly() {
+    //Edited lines leave their old strings and data bytes behind; start afresh once enough has piled up.
+    static const size_t STORAGE_LIMIT = 1u << 20;
+    if(pool->bytesAllocated() + arena.size() + expressions.size() * sizeof(ExprItem) > STORAGE_LIMIT) clearCache();
+    generation++;
     memaddr_t targetOffset = 0; //where to put the next address. We start at 0 unless specified otherwise.
-    std::map<std::string, size_t, StringInsensitive> labelTable; //table for labels to instructions (index references stored)
-    std::unordered_map<unsigned, size_t>::iterator overlap; //Overlap reference if occured.
-    std::unordered_map<unsigned, size_t> addressTable; //Table for addresses assigned to each instruction. Used for checking address overlap.
+    //Operands and DB/DW items which use symbols or $. Each is evaluated as soon as all its symbols are defined, and then written
+    //into the image (and into the operand of its instruction, if it is one).
+    const size_t NO_PENDING = Symbol::NO_PENDING;
+    struct Fixup {
+        ///Offset of the expression in the expression arena
+        uint_least32_t expression;
+        ///Where the value goes, and the value of $
+        memaddr_t address, here;
+        ///One byte or two?
+        bool isByte;
+        ///Line number, for errors
+        unsigned lineNumber;
+        ///Index of the instruction whose operand this is; NO_PENDING for data
+        size_t instruction;
+        ///Key of the global label above the line, for local labels
+        string_id_t scope;
+    };
+    std::vector<Fixup> fixups;
+    //Symbols: the value once defined, and until then the chain of fixups (indices) which wait for it. The chain is linked
+    //through nextPending; its fixups are evaluated again when the symbol gets defined (and move on to the chain of another
+    //symbol if they use more than one undefined symbol).
+    std::vector<size_t> nextPending;
+    symbols.clear(); reserved.clear();
+    //Key of the last global label; local labels (.name) are qualified with it.
+    string_id_t scope = 0u;
+    const auto symbolKey = [&](string_id_t name, string_id_t scope) {
+        return makeSymbolKey(pool->str(name)[0] == '.' ? scope : 0u, pool->key(name));
+    };
+    //Object modules: addresses are offsets from the start of the module until an ORG or DATA makes the module absolute (which
+    //is only allowed before anything has been laid out). At the end, symbols still undefined are imported.
+    bool relocatable = object != nullptr, laidOut = false, importing = false;
+    std::unordered_map<string_id_t, uint_least32_t> imports;
+    if(object != nullptr) object->clear();
+    //Evaluate an expression: EVALUATED, PENDING (and the undefined symbol) if a symbol is not defined yet, or FAILED (after
+    //reporting why). Values which are not absolute (only in object modules) are left as offsets from base.
+    enum Outcome {EVALUATED, PENDING, FAILED};
+    const auto evaluate = [&](const ExprItem *expression, memaddr_t here, string_id_t scope, unsigned lineNumber, bool isByte,
+                              data16_t &value, ExprBase &base, string_id_t &undefined) {
+        const RelocatableLookup lookup = [&](string_id_t name, data16_t &value, ExprBase &base) {
+            const Symbol *const symbol = symbols.find(symbolKey(name, scope));
+            if(symbol != nullptr && symbol->isDefined()) {
+                value = symbol->value; if(symbol->relocatable) base = ExprBase(ExprBase::MODULE);
+                return true;
+            }
+            if(!importing || pool->str(name)[0] == '.') return false; //local labels are never imported
+            value = 0u; base = ExprBase(ExprBase::IMPORT, pool->key(name)); return true;
+        };
+        switch(evaluateRelocatable(expression, here, relocatable ? ExprBase(ExprBase::MODULE) : ExprBase(), lookup, value, base, undefined)) {
+        case EXPR_UNDEFINED: return PENDING;
+        case EXPR_DIVISION_BY_ZERO: report(SyntaxError(lineNumber, 0, 0, "Division by zero")); return FAILED;
+        case EXPR_NOT_RELOCATABLE: report(SyntaxError(lineNumber, 0, 0, "Expression cannot be relocated by the linker")); return FAILED;
+        default: break;
+        }
+        if(!base.isAbsolute()) {
+            if(isByte && base.part == ExprItem::END && base.kind == ExprBase::MODULE) {
+                report(SyntaxError(lineNumber, 0, 0, "An address does not fit in a byte (use HIGH or LOW)"));
+                return FAILED;
+            }
+            return EVALUATED;
+        }
+        if(isByte && !fitsInByte(value)) {report(SyntaxError(lineNumber, 0, 0, "Value does not fit in a byte")); return FAILED;}
+        if(isByte) value &= 0xFFu;
+        return EVALUATED;
+    };
+    //Evaluate fixups[k] and write its value, or put it on the chain of the symbol it waits for. A fixup in error is dropped.
+    const auto resolve = [&](size_t k) {
+        const Fixup &f = fixups[k];
+        data16_t value; ExprBase base; string_id_t undefined;
+        switch(evaluate(&expressions[f.expression], f.here, f.scope, f.lineNumber, f.isByte, value, base, undefined)) {
+        case FAILED: return;
+        case PENDING: {
+            Symbol &target = symbols.get(symbolKey(undefined, f.scope));
+            nextPending[k] = target.pending; target.pending = k;
+            return;
+        }
+        default: break;
+        }
+        if(!base.isAbsolute()) {
+            //Left for the linker; the image gets the value for a module at address 0 (and imported symbols of 0).
+            uint_least32_t symbol = ObjectModule::MODULE_BASE;
+            if(base.kind == ExprBase::IMPORT) {
+                const std::pair<std::unordered_map<string_id_t, uint_least32_t>::iterator, bool> it =
+                        imports.insert({base.symbol, (uint_least32_t)object->imports.size()});
+                if(it.second) object->imports.push_back(pool->str(base.symbol));
+                symbol = it.first->second;
+            }
+            object->relocations.push_back(ObjectModule::Relocation{f.address, value, f.isByte, base.part, symbol});
+            if(base.part == ExprItem::HIGH) value >>= 8;
+            else if(base.part == ExprItem::LOW || f.isByte) value &= 0xFFu;
+        }
+        image[f.address] = (data8_t)(value & 0xFFu);
+        if(!f.isByte) image[(f.address + 1u) & 0xFFFFu] = (data8_t)((value >> 8) & 0xFFu);
+        if(f.instruction != NO_PENDING) instructions[f.instruction].operand = value;
+    };
+    //Cross-references of the listing: every symbol in an expression which is evaluated.
+    const auto addReferences = [&](const ExprItem *expression, string_id_t scope, unsigned lineNumber) {
+        for(; expression->op != ExprItem::END; expression++)
+            if(expression->op == ExprItem::SYMBOL) listing->addReference(symbolKey(expression->value, scope), lineNumber);
+    };
+    const auto addFixup = [&](const Fixup &f) {
+        if(listing != nullptr) addReferences(&expressions[f.expression], f.scope, f.lineNumber);
+        fixups.push_back(f); nextPending.push_back(NO_PENDING); resolve(fixups.size() - 1u);
+    };
+    //Define a symbol and evaluate the fixups waiting for it. Global labels open a new scope for local ones. resolve() may insert symbols (invalidating symbol) and re-chain.
+    const auto define = [&](string_id_t name, Symbol::Kind kind, data16_t value, bool isRelocatable, unsigned lineNumber) {
+        if(kind == Symbol::LABEL && pool->str(name)[0] != '.') scope = pool->key(name);
+        Symbol &symbol = symbols.get(symbolKey(name, scope));
+        if(!symbol.canDefineAs(kind)) {
+            report(SyntaxError(lineNumber, 0, 0, kind == Symbol::LABEL ? "Label repeated" : "Symbol already defined"));
+            return;
+        }
+        symbol.kind = kind; symbol.value = value; symbol.relocatable = isRelocatable; symbol.lineNumber = lineNumber;
+        if(isRelocatable) laidOut = true;
+        size_t k = symbol.pending; symbol.pending = NO_PENDING;
+        while(k != NO_PENDING) {const size_t next = nextPending[k]; nextPending[k] = NO_PENDING; resolve(k); k = next;}
+    };
+    //Evaluate an expression which may only use symbols defined above it. Only EQU and SET may have relocatable values. Returns
+    //false (after reporting why) if it cannot be evaluated.
+    const auto evaluateNow = [&](const ExprItem *expression, unsigned lineNumber, bool allowRelocatable, data16_t &value, bool &isRelocatable) {
+        string_id_t undefined; ExprBase base;
+        if(listing != nullptr) addReferences(expression, scope, lineNumber);
+        switch(evaluate(expression, targetOffset, scope, lineNumber, false, value, base, undefined)) {
+        case FAILED: return false;
+        case PENDING:
+            report(SyntaxError(lineNumber, 0, 0, std::string("Undefined symbol ") + pool->str(undefined) +
+                               " (forward references are not allowed here)"));
+            return false;
+        default: break;
+        }
+        isRelocatable = !base.isAbsolute();
+        if(isRelocatable && !(allowRelocatable && base.kind == ExprBase::MODULE && base.part == ExprItem::END)) {
+            report(SyntaxError(lineNumber, 0, 0, "A relocatable value is not allowed here"));
+            return false;
+        }
+        return true;
+    };
+    //Operands of IF and REPT. These are not cached: the translator only raises a SyntaxError for an operand in error.
+    preprocessor.evaluate = [&](const SourceLine &line, size_t start, data16_t &value) {
+        lineTokenizer.reset(line.text, line.length);
+        lineTokenizer.position = start; lineTokenizer.columnNumber = (unsigned)start + 1u;
+        const ExprItem *expression; bool isRelocatable;
+        try {expression = translator.translateExpression(value);} catch (SyntaxError const &ex) {
+            report(line.error(ex.columnNumber, ex.position, ex.what));
+            return false;
+        }
+        return expression == nullptr || evaluateNow(expression, line.lineNumber, false, value, isRelocatable);
+    };
+    preprocessor.report = [&](const SyntaxError &ex) {report(ex);};
+    if(listing != nullptr) {listing->clear(); preprocessor.consumed = [&](const SourceLine &line) {listing->addLine(line);};}
+    else preprocessor.consumed = nullptr;
+    //Claim bytes of the image for a line; the owner array catches any overlap, including partial ones (reported once per line).
+    const auto claim = [&](memaddr_t address, size_t length, unsigned line) {
+        unsigned overlapped = 0u;
+        for(size_t k = 0; k < length; k++) {
+            unsigned &o = owner[(address + k) & 0xFFFFu];
+            if(o != 0u && overlapped == 0u) overlapped = o;
+            o = line;
+        }
+        if(overlapped != 0u) report(SyntaxError(line, 0, 0, "Address overlap with line " + unsignedNumber(overlapped)));
+        if(length != 0u) laidOut = true;
+    };
     instructions.clear();
-    //Put addresses to instructions
-    do {
-        QCoreApplication::processEvents();
-        Instruction i = translator.translateOneLine();
-        if(i.code == nullptr) continue;
-        else if(i.code->isPseudocode) {
-            if(i.code == &DATA) {
-                overlap = addressTable.find(i.operand);
-                if(overlap != addressTable.end())
-                    throw SyntaxError(i.lineNumber, 0, 0, "Address overlap with instruction at line " + unsignedNumber(instructions[overlap->second].lineNumber));
+    std::fill(image.begin(), image.end(), (data8_t)0u);
+    std::fill(owner.begin(), owner.end(), 0u);
+    //Single pass: expand, translate (through the cache), lay out, emit bytes and resolve labels line by line. A line in error
+    //is reported and skipped; the lines after it are assembled as usual.
+    preprocessor.reset(source.data(), source.length());
+    SourceLine line; Instruction i;
+    while(true) {
+        if(poll()) return false;
+        if(!preprocessor.nextLine(line)) break;
+        if(!translateLine(line, i) || i.code == nullptr) {if(listing != nullptr) listing->addLine(line); continue;}
+        i.address = targetOffset;
+        //Operands of these are needed right away: only symbols defined above may be used.
+        bool isRelocatable = false;
+        if(i.code->isPseudocode && i.code != &DB && i.code != &DW && i.expression != 0u &&
+           !evaluateNow(&expressions[i.expression - 1u], i.lineNumber, i.code == &EQU || i.code == &SET, i.operand, isRelocatable)) {
+            if(listing != nullptr) listing->addLine(line);
+            continue;
+        }
+        if(i.code == &INCBIN && !includeBinary(i, line)) {if(listing != nullptr) listing->addLine(line); continue;}
+        if(i.code == &EQU || i.code == &SET) {
+            define(i.label, i.code == &EQU ? Symbol::EQU : Symbol::SET, i.operand, isRelocatable, i.lineNumber);
+            if(listing != nullptr) listing->addValue(line, i.operand);
+            continue;
+        }
+        if(i.code == &ORG || i.code == &DATA) {
+            if(relocatable && laidOut) {
+                report(SyntaxError(i.lineNumber, 0, 0, "ORG and DATA must come before any code in an object module"));
+                if(listing != nullptr) listing->addLine(line);
+                continue;
             }
+            relocatable = false;
+            if(i.code == &DATA) claim(i.operand, i.dataLength, i.lineNumber);
+            if(listing != nullptr) listing->addLine(line, i.operand, i.code == &DATA ? i.dataLength : 0u);
             pseudocodeProcessors[i.code](i, targetOffset); continue;
         }
-        overlap = addressTable.find(targetOffset);
-        if(overlap != addressTable.end())
-            throw SyntaxError(i.lineNumber, 0, 0, "Address overlap with instruction at line " + unsignedNumber(instructions[overlap->second].lineNumber));
-        i.address = targetOffset;
-        instructions.push_back(i); addressTable[i.address] = instructions.size()-1u;
-        targetOffset = (targetOffset + i.code->bytesRequired) & 0xFFFFu;
-        if(!i.label.empty()) {
-            if(labelTable.find(i.label) != labelTable.end())
-                throw SyntaxError(i.lineNumber, 0, 0, "Label repeated");
-            labelTable.insert({i.label, instructions.size()-1u});
-        }
-    } while (tok.ttype != Tokenizer::END_OF_FILE);
-    //Put target operand addresses for JMPs and CALLs.
-    for(size_t i = 0; i < instructions.size(); i++) {
-        QCoreApplication::processEvents();
-        if(!instructions[i].toLabel.empty()) {
-            std::map<std::string, size_t, StringInsensitive>::iterator node = labelTable.find(instructions[i].toLabel);
-            if(node == labelTable.end()) throw SyntaxError(instructions[i].lineNumber, 0, 0, "Target label not found");
-            instructions[i].operand = (data16_t) (instructions[node->second].address & 0xFFFFu);
-        }
-    }
-    std::stable_sort(instructions.begin(), instructions.end(), InstructionAddressComparator()); //sort according to instruction addresses.
-
-    //Put instructions into processor memory.
-    for(size_t i = 0; i < instructions.size(); i++) {
-        QCoreApplication::processEvents();
-        data8_t buf[3]; buf[0] = instructions[i].code->code;
-        if(instructions[i].code->bytesRequired >= 2) buf[1] = (data8_t)(instructions[i].operand & 0xFFu);
-        if(instructions[i].code->bytesRequired == 3) buf[2] = (data8_t)((instructions[i].operand >> 8) & 0xFFu);
-        processor->overwrite(buf, instructions[i].address, instructions[i].code->bytesRequired);
+        //Instructions, DB, DW and DS take up memory at the current address.
+        const memsize_t size = i.code == &DS ? i.operand : i.code->isPseudocode ? i.dataLength : i.code->bytesRequired;
+        claim(targetOffset, size, i.lineNumber);
+        if(listing != nullptr) listing->addLine(line, i.address, i.code == &DS ? 0u : size);
+        targetOffset = (targetOffset + size) & 0xFFFFu;
+        if(i.label != 0u) define(i.label, Symbol::LABEL, i.address, relocatable, i.lineNumber);
+        if(i.code->isPseudocode) {
+            pseudocodeProcessors[i.code](i, targetOffset);
+            //Deferred DB/DW items: an AT item with the offset of the item, followed by its expression. An END item ends the list.
+            if(i.expression != 0u) for(uint_least32_t e = i.expression - 1u; expressions[e].op == ExprItem::AT; e++) {
+                const memaddr_t address = (i.address + expressions[e].value) & 0xFFFFu;
+                addFixup(Fixup{e + 1u, address, i.address, i.code == &DB, i.lineNumber, NO_PENDING, scope});
+                while(expressions[e].op != ExprItem::END) e++;
+            }
+            continue;
+        }
+        instructions.push_back(i);
+        emitInstruction(i); //operands which are not known yet are written when they are
+        if(i.expression != 0u)
+            addFixup(Fixup{i.expression - 1u, (memaddr_t)((i.address + 1u) & 0xFFFFu), i.address, i.code->bytesRequired == 2,
+                           i.lineNumber, instructions.size() - 1u, scope});
+    }
+    if(object != nullptr) {
+        //Whatever is still pending uses symbols of other modules: evaluate it again, importing them.
+        std::vector<size_t> pending;
+        for(SymbolTable::Entry &entry : symbols.getEntries()) {
+            for(size_t k = entry.symbol.pending; k != NO_PENDING; k = nextPending[k]) pending.push_back(k);
+            entry.symbol.pending = NO_PENDING;
+        }
+        std::sort(pending.begin(), pending.end());
+        importing = true;
+        for(const size_t k : pending) {nextPending[k] = NO_PENDING; resolve(k);}
+    }
+    //Symbols still pending were never defined. Report every line which uses one (once per line).
+    std::vector<unsigned> missing;
+    for(const SymbolTable::Entry &entry : symbols.getEntries())
+        for(size_t k = entry.symbol.pending; k != NO_PENDING; k = nextPending[k]) missing.push_back(fixups[k].lineNumber);
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    for(const unsigned lineNumber : missing) report(SyntaxError(lineNumber, 0, 0, "Target label not found"));
+    //Errors found at the end of the run (and those of fixups resolved late) go among the others, in line order. SyntaxError
+    //cannot be assigned, so the errors are copied over in order.
+    const auto byLine = [](const SyntaxError &a, const SyntaxError &b) {return a.lineNumber < b.lineNumber;};
+    if(!std::is_sorted(diagnostics->begin(), diagnostics->end(), byLine)) {
+        std::vector<const SyntaxError *> order;
+        for(const SyntaxError &ex : *diagnostics) order.push_back(&ex);
+        std::stable_sort(order.begin(), order.end(), [&](const SyntaxError *a, const SyntaxError *b) {return byLine(*a, *b);});
+        std::vector<SyntaxError> sorted;
+        sorted.reserve(order.size());
+        for(const SyntaxError *ex : order) sorted.push_back(*ex);
+        diagnostics->swap(sorted);
+    }
+    //Drop cached lines which are no longer part of the source.
+    for(std::unordered_map<uint_fast64_t, CachedLine>::iterator it = lineCache.begin(); it != lineCache.end();)
+        if(it->second.generation != generation) it = lineCache.erase(it); else ++it;
+    if(listing != nullptr) listing->finish(image, symbols, *pool);
+    if(!diagnostics->empty()) return true; //nothing is committed
+    if(object != nullptr) buildObject(relocatable);
+    else commit();
+    return true;
+}
+void BasicAssembler::buildObject(bool relocatable) {
+    object->relocatable = relocatable;
+    //A relocatable module takes up the space from its start to its last byte, including blocks reserved by DS.
+    if(relocatable) for(memsize_t end = MEMORY_SIZE; end > 0u; end--) if(owner[end-1u] != 0u) {object->size = end; break;}
+    //Reserved blocks are not written, so they are not part of any section.
+    for(const std::pair<memsize_t, memsize_t> &block : reserved) std::fill(owner.begin() + block.first, owner.begin() + block.second, 0u);
+    for(memsize_t first = 0u; first < MEMORY_SIZE;) {
+        if(owner[first] == 0u) {first++; continue;}
+        memsize_t last = first;
+        while(last < MEMORY_SIZE && owner[last] != 0u) last++;
+        object->sections.push_back(ObjectModule::Section{(memaddr_t)first, std::vector<data8_t>(image.begin() + first, image.begin() + last)});
+        first = last;
+    }
+    //Global labels and constants are exported (their names are the upper-case keys of the pool).
+    for(const SymbolTable::Entry &entry : symbols.getEntries()) {
+        const Symbol &symbol = entry.symbol;
+        const string_id_t name = (string_id_t)(entry.key & 0xFFFFFFFFu);
+        if((entry.key >> 32) != 0u || pool->str(name)[0] == '.' || !(symbol.kind == Symbol::LABEL || symbol.kind == Symbol::EQU)) continue;
+        object->exports.push_back(ObjectModule::Export{pool->str(name), symbol.value, symbol.relocatable});
+    }
+}
+bool BasicAssembler::includeBinary(Instruction &i, const SourceLine &line) {
+    const std::string name = pool->str(i.toLabel);
+    QFile file(QString::fromStdString(name));
+    if(!file.open(QIODevice::ReadOnly)) {report(line.error(0u, 0, "Cannot read file " + name)); return false;}
+    const qint64 size = file.size();
+    if(size > (qint64)MEMORY_SIZE) {report(line.error(0u, 0, "File " + name + " is too large for the address space")); return false;}
+    i.dataLength = (uint_least32_t)size;
+    if(size == 0) return true;
+    const uchar *const data = file.map(0, size);
+    if(data == nullptr) {report(line.error(0u, 0, "Cannot read file " + name)); return false;}
+    //At most two copies: up to the end of memory, and the part which wraps around to address 0.
+    const size_t first = std::min((size_t)size, (size_t)(MEMORY_SIZE - i.address));
+    std::memcpy(image.data() + i.address, data, first);
+    std::memcpy(image.data(), data + first, (size_t)size - first);
+    file.unmap(const_cast<uchar *>(data));
+    return true;
+}
+void BasicAssembler::emitInstruction(const Instruction &i) {
+    const memaddr_t address = i.address;
+    image[address] = i.code->code;
+    if(i.code->bytesRequired >= 2) image[(address + 1u) & 0xFFFFu] = (data8_t)(i.operand & 0xFFu);
+    if(i.code->bytesRequired == 3) image[(address + 2u) & 0xFFFFu] = (data8_t)((i.operand >> 8) & 0xFFu);
+}
+bool BasicAssembler::runAssembly(std::vector<SyntaxError> &diagnostics, ObjectModule *module, Listing *listing) {
+    diagnostics.clear();
+    object = module; this->listing = listing; this->diagnostics = &diagnostics;
+    const bool finished = doAssembly();
+    object = nullptr; this->listing = nullptr; this->diagnostics = nullptr;
+    return finished;
+}
+void assembleSource(const char *source, size_t length, AssemblyResult &result) {
+    //A fresh assembler per call: nothing is shared between calls except the (immutable) opcode and mnemonic tables.
+    BasicAssembler assembler;
+    assembler.source.assign(source, length);
+    assembler.runAssembly(result.diagnostics);
+    result.image = assembler.getImage(); result.reserved = assembler.getReserved();
+    result.instructions.swap(assembler.instructions);
+    result.pool = assembler.getStringPool(); result.symbols = assembler.getSymbols();
+}
+
+//Assembler
+
+#include <QCoreApplication>
+#include <QThread>
+Assembler::Assembler(Processor *proc) : QObject(proc), processor(proc) {}
+bool Assembler::poll() {
+    //Polling the event loop only makes sense (and is only safe) on the GUI thread; background runs are cancelled instead.
+    const QCoreApplication *const application = QCoreApplication::instance();
+    if(application != nullptr && QThread::currentThread() == application->thread()) QCoreApplication::processEvents();
+    return BasicAssembler::poll();
+}
+void Assembler::commit() {
+    if(processor == nullptr) return;
+    //Blocks reserved by DS are never written: the stretches between them are committed separately.
+    std::sort(reserved.begin(), reserved.end());
+    memsize_t from = 0u;
+    for(const std::pair<memsize_t, memsize_t> &block : reserved) {
+        if(block.first > from) commitRange(from, block.first);
+        from = std::max(from, block.second);
     }
+    if(from < MEMORY_SIZE) commitRange(from, MEMORY_SIZE);
+}
+void Assembler::commitRange(memsize_t first, memsize_t last) {
+    //Bytes not written by the program are 0 in the image, so stale bytes of an earlier program are cleared as well.
+    while(first < last && image[first] == processor->getMemoryByte(first)) first++;
+    if(first == last) return; //nothing changed
+    while(image[last-1u] == processor->getMemoryByte(last-1u)) last--;
+    processor->overwrite(image.data() + first, first, last - first);
 }
 //public slots
 void Assembler::assemble() {
-    try {doAssembly();} catch (SyntaxError const &ex) {
-        emit assemblyError(ex); return;
-    }
+    std::vector<SyntaxError> diagnostics;
+    if(!runAssembly(diagnostics, nullptr, &assemblyListing)) return; //cancelled; nothing to report
+    if(!diagnostics.empty()) {emit assemblyError(diagnostics.front()); emit assemblyErrors(diagnostics); return;}
     emit assemblyFinished();
 }
@@ -27,29 +27,35 @@ SOFTWARE.*/
 #include <cstring>
 #include <cctype>
 #include <cstdio>
-#include <iostream>
-#include <stack>
 #include <map>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <QException>
 #include "commdefs.h"
 #include "opcodes.h"
+#include "stringpool.h"
+#include "symboltable.h"
+#include "expression.h"
+#include "linker.h"
+#include "listing.h"
 
 ///Represents a single instruction line. This object is used to hold transitional information and is NOT used to execute the program.
-///However, this object will be used to retain debugging information.
+///However, this object will be used to retain debugging information. Plain data (cheap to copy): label names are interned in a
+///StringPool and DATA bytes live in a byte arena, both owned by the assembler which produced the record.
 struct Instruction {
     ///Line number for this instruction.
     unsigned lineNumber;
     ///This is the address in memory assigned to this instruction line. This can be relative or exact.
     memaddr_t address;
-    ///The label for this particular line. Example: "LOOP: CALL SUB" would assign "LOOP" here.
-    std::string label;
+    ///The label for this particular line. Example: "LOOP: CALL SUB" would assign "LOOP" here. 0 (the empty string) if none.
+    string_id_t label;
     ///The opcode for this instruction (example: CALL). Only one of the valid instances.
     const opcode *code;
-    ///The label to which this instruction will point to (example: "SUB"). This is an empty string if it is not one of the jump
-    ///or call instructions and can then be ignored.
-    std::string toLabel;
+    ///The label to which this instruction will point to (example: "SUB"), or more generally the text of an operand expression
+    ///which uses symbols or $ (example: "TABLE+2"), or the file name of INCBIN. This is 0 (the empty string) if the operand is a
+    ///plain constant.
+    string_id_t toLabel;
     ///Exact value of the operand. This can be ignored if code->bytesRequired is 1; only the least-significant 8 bits are valid if
     ///code->bytesRequired is 2, and the full value is valid if code->bytesRequired is 3. If code->bytesRequired is 3 and the
     ///operand is an address; it can be relative or exact. Also note that in some cases (even though code->bytesRequired is 1) the
@@ -57,16 +63,14 @@ struct Instruction {
     ///In any case this extra exceptional information will be resolved and removed from this field by the assembler when this
     ///object is processed.
     data16_t operand;
-    ///Extra operands if required (support for pseudocode).
-    std::vector<data8_t> extraOperands;
+    ///Extra operands if required (support for pseudocode): dataLength bytes starting at dataOffset in the byte arena.
+    uint_least32_t dataOffset, dataLength;
+    ///1 + offset of the operand expression in the expression arena, if the operand uses symbols or $ and has to be evaluated
+    ///during assembly; 0 if operand already holds the value.
+    uint_least32_t expression;
 
     ///Default constructor
-    Instruction() : lineNumber(0u), address(0u), label(""), code(nullptr), toLabel(""), operand(0u), extraOperands((size_t)0u) {}
-    ///Default copy constructor (required because we are using std::string)
-    Instruction(const Instruction &o) : lineNumber(o.lineNumber), address(o.address), label(o.label), code(o.code), toLabel(o.toLabel), operand(o.operand), extraOperands(o.extraOperands)
-    {extraOperands.shrink_to_fit();}
-    ///Default virtual destructor (REQUIRED for interop with Qt).
-    virtual ~Instruction() = default;
+    Instruction() : lineNumber(0u), address(0u), label(0u), code(nullptr), toLabel(0u), operand(0u), dataOffset(0u), dataLength(0u), expression(0u) {}
 
     ///Is instruction line empty? used for comments.
     bool isEmpty() const {return code == nullptr;}
@@ -111,18 +115,56 @@ struct SyntaxError : public QException {
     SyntaxError *clone() const {return new SyntaxError(*this);}
 };
 Q_DECLARE_METATYPE(SyntaxError)
+Q_DECLARE_METATYPE(std::vector<SyntaxError>)
+Q_DECLARE_METATYPE(std::string)
 
-///Splits an assembler source stream into individual tokens.
+///A view of one token inside the tokenizer's source buffer. No characters are copied; the view is only valid as long as
+///the source buffer is alive and unmodified.
+struct TokenView {
+    ///First character of the token (inside the source buffer).
+    const char *data;
+    ///Offset of the first character from the start of the source buffer.
+    size_t offset;
+    ///Number of characters in the token.
+    size_t size;
+
+    ///Default constructor (empty token)
+    TokenView() : data(""), offset(0u), size(0u) {}
+    ///Constructor
+    TokenView(const char *data, size_t offset, size_t size) : data(data), offset(offset), size(size) {}
+
+    ///Number of characters in the token.
+    size_t length() const {return size;}
+    ///Is the token empty?
+    bool empty() const {return size == 0u;}
+    ///Character at index i (no bounds checking).
+    char operator[](size_t i) const {return data[i];}
+    ///Copy the token out of the source buffer. Only call this when the text has to outlive the buffer.
+    std::string str() const {return std::string(data, size);}
+    ///Case-insensitive comparison with a null-terminated string.
+    bool equalsIgnoreCase(const char *s) const {
+        size_t i = 0;
+        for(; i < size && s[i] != '\0'; i++) if(std::toupper((unsigned char)data[i]) != std::toupper((unsigned char)s[i])) return false;
+        return i == size && s[i] == '\0';
+    }
+};
+
+///Splits an assembler source buffer into individual tokens. The buffer is read in place (it may be a std::string or a
+///memory-mapped file) and must outlive the tokenizer; tokens are returned as views into it.
 struct Tokenizer {
     ///Last token read and parsed. Can contain spaces.
-    std::string token;
-    ///Our source to read characters from
-    std::istream &in;
+    TokenView token;
+    ///Our source to read characters from. Not owned.
+    const char *source;
+    ///Number of characters in source.
+    size_t sourceLength;
+    ///Offset of the next character to be read from source.
+    size_t position;
     ///Token types which can be parsed by this tokenizer
     enum TokenType : int {
         ///Unrecognized or unacceptable character
         CHAR_ERROR = -3,
-        ///Stream error
+        ///Stream error (never produced by a buffer; kept so that existing users can still map it)
         STREAM_ERROR = -2,
         ///End of file
         END_OF_FILE = EOF,
@@ -142,7 +184,7 @@ struct Tokenizer {
         IDENTIFIER,
         ///Decimal number (contains only digits 0-9; and ends in d or D.)
         DECNUMBER,
-        ///Hexadecimal number (contains digits 0-9, a-f, A-F and may end in h or H.)
+        ///Hexadecimal number (contains digits 0-9, a-f, A-F and may end in h or H; or starts with 0x or $ instead.)
         HEXNUMBER,
         ///Comment (starts with ';' and should be followed by a NEWLINE token)
         COMMENT,
@@ -150,33 +192,52 @@ struct Tokenizer {
         ///Binary number (only 0 and 1), ends in b or B.
         BINNUMBER,
         ///Octal number (0 to 7), ends in o or O (letter O, not zero)
-        OCTNUMBER
+        OCTNUMBER,
+        ///Operator, parenthesis or $ in an operand expression
+        OPERATOR,
+        ///Text in single or double quotes, on one line (the token includes the quotes)
+        STRING
     } ttype;
+    ///Mnemonic identifier of the last token if it is an OPCODE or PSEUDOCODE; NO_MNEMONIC otherwise.
+    mnemonic_t mnemonic;
+    ///Value of the last token if it is a number (converted while the token is read). Values which do not fit in 16 bits
+    ///saturate at NUMBER_OVERFLOW.
+    uint_least32_t number;
+    ///Value of numbers which do not fit in 16 bits.
+    static const uint_least32_t NUMBER_OVERFLOW = 0x10000u;
     ///Current line number
     unsigned lineNumber;
     ///Current column number
     unsigned columnNumber;
-    ///Position in stream. Casts are necessary; return -1 if we have reached end.
-    int charNumber() const {return in.tellg() > 0 ? (int)in.tellg() - (int)putbackBuffer.size() : -1;}
+    ///Position in the buffer (offset of the next character to be read).
+    int charNumber() const {return (int)position;}
 
-    ///Constructor
-    explicit Tokenizer(std::istream &in) : token(""), in(in), ttype(NONE), lineNumber(1u), columnNumber(1u) {}
+    ///Constructor over a buffer of given length.
+    Tokenizer(const char *source, size_t length) : source(source), sourceLength(length), position(0u), ttype(NONE), mnemonic(NO_MNEMONIC), number(0u), lineNumber(1u), columnNumber(1u) {}
+    ///Constructor over the contents of a string. The string must not be modified or destroyed while the tokenizer is in use.
+    explicit Tokenizer(const std::string &source) : Tokenizer(source.data(), source.size()) {}
+
+    ///Restart on another buffer; lineNumber is the line number of its first line.
+    void reset(const char *source, size_t length, unsigned lineNumber = 1u) {
+        this->source = source; sourceLength = length; position = 0u;
+        token = TokenView(); ttype = NONE; mnemonic = NO_MNEMONIC; number = 0u;
+        this->lineNumber = lineNumber; columnNumber = 1u;
+    }
 
     ///Obtain next token
     TokenType getNextToken();
 
-    ///local putback buffer.
-    std::stack<char> putbackBuffer;
-    ///Get next character from stream
-    char getNextChar();
-    ///Peek next character from stream
-    char peekNextChar();
-    ///Push next character (unget) to stream
-    void putBackChar(char ch) {putbackBuffer.push(ch);}
-    ///Is stream good?
-    bool isGood() {return putbackBuffer.empty() ? in.good() : true;}
+    ///Get next character from the buffer ('\0' at the end)
+    char getNextChar() {
+        if(isEndOfFile()) return '\0';
+        const char ch = source[position++];
+        if(ch == '\n') {lineNumber++; columnNumber = 1;} else columnNumber++;
+        return ch;
+    }
+    ///Peek next character from the buffer ('\0' at the end)
+    char peekNextChar() const {return isEndOfFile() ? '\0' : source[position];}
     ///We have reached end of file or not
-    bool isEndOfFile() {return putbackBuffer.empty() ? in.eof() : false;}
+    bool isEndOfFile() const {return position >= sourceLength;}
 
     ///Separator characters
     static bool isSeparator(char ch) {
@@ -186,109 +247,417 @@ struct Tokenizer {
         default: return false;
         }
     }
-    ///is decimal number? ends with d or D
-    static bool isDecimalNumber(const char * const s) {
-        //for(const char *p = s; *p != '\0'; p++) if(!std::isdigit(*p)) return false;
-        //return true;
-        size_t len = std::strlen(s);
-        if(len <= 1) return false;
-        for(size_t i = 0; i < (len-1u); i++) if(!std::isdigit(s[i])) return false;
-        return s[len-1] == 'd' || s[len-1] == 'D';
-    }
-    ///is hexadecimal number? ends with H.
-    static bool isHexNumber(const char * const s) {
-        size_t len = std::strlen(s);
-        if(len <= 1) return false;
-        for(size_t i = 0; i < (len-1u); i++) if(!(std::isdigit(s[i]) || (s[i] >= 'a' && s[i] <= 'f') || (s[i] >= 'A' && s[i] <= 'F'))) return false;
-        return s[len-1] == 'h' || s[len-1] == 'H';
-    }
-    static bool isImplicitHexNumber(const char * const s) {
-        size_t len = std::strlen(s);
-        if(len < 1) return false;
-        if(!std::isdigit(s[0])) return false; //Must start with digit
-        for(size_t i = 1; i < len; i++) if(!(std::isdigit(s[i]) || (s[i] >= 'a' && s[i] <= 'f') || (s[i] >= 'A' && s[i] <= 'F'))) return false;
-        return true;
-    }
-    static bool isBinNumber(const char * const s) {
-        size_t len = std::strlen(s);
-        if(len <= 1) return false;
-        for(size_t i = 0; i < (len-1u); i++) if(!(s[i] == '0' || s[i] == '1')) return false;
-        return s[len-1] == 'b' || s[len-1] == 'B';
+    ///Operator characters (single-character tokens of operand expressions)
+    static bool isOperator(char ch) {
+        switch(ch) {
+        case '+': case '-': case '*': case '/': case '(': case ')': case '$': return true;
+        default: return false;
+        }
     }
-    static bool isOctNumber(const char * const s) {
-        size_t len = std::strlen(s);
-        if(len <= 1) return false;
-        for(size_t i = 0; i < (len-1u); i++) if(!(s[i] >= '0' && s[i] <= '7')) return false;
-        return s[len-1] == 'o' || s[len-1] == 'O';
+    ///Value of a digit or letter as a digit (letters count from 10, in either case); 36 or more for other characters.
+    static unsigned digitValue(char ch) {
+        if(ch >= '0' && ch <= '9') return (unsigned)(ch - '0');
+        if(ch >= 'a' && ch <= 'z') return (unsigned)(ch - 'a') + 10u;
+        if(ch >= 'A' && ch <= 'Z') return (unsigned)(ch - 'A') + 10u;
+        return 36u;
     }
+private:
+    ///Read an alphanumeric word (a mnemonic, a number or an identifier), classifying it and converting it if it is a number in
+    ///the same scan.
+    TokenType readWord();
+    ///Read a number written as $ followed by hexadecimal digits; returns false (reading nothing) if $ is not followed by one.
+    bool readDollarNumber();
 };
 
 ///Translates 8085 assembly source line-by-line (one instruction at a time).
 struct LineTranslator {
     ///Source
     Tokenizer &tok;
+    ///Pool into which label names are interned.
+    StringPool *pool;
+    ///Arena to which DATA bytes are appended.
+    std::vector<data8_t> *arena;
+    ///Arena to which operand expressions which cannot be evaluated yet are appended.
+    std::vector<ExprItem> *expressions;
     ///Constructor
-    LineTranslator(Tokenizer &);
+    LineTranslator(Tokenizer &, StringPool *stringPool, std::vector<data8_t> *dataArena, std::vector<ExprItem> *expressionArena);
     ///Translate the next incoming line. May throw SyntaxErrors, will return an empty Instruction object if the current line is a comment.
     Instruction translateOneLine();
+    ///Translate the rest of the line as an expression (the operand of IF and REPT). Returns nullptr (and the value) if it is
+    ///constant, or else its postfix form, valid until the next line is translated. May throw SyntaxErrors.
+    const ExprItem *translateExpression(data16_t &value);
 private:
-    ///Token processors respective for each mnemonic.
-    std::map<const char *, std::function<void(Instruction &, const char *)>, CaseInsensitive> mnemonicProcessors;
-    ///Token processors respective for each pseudocode.
-    std::map<const char *, std::function<void(Instruction &, const char *)>, CaseInsensitive> pseudocodeProcessors;
+    ///Token processors respective for each mnemonic, indexed by mnemonic identifier (empty for pseudocodes).
+    std::vector<std::function<void(Instruction &, mnemonic_t)>> mnemonicProcessors;
+    ///Token processors respective for each pseudocode, indexed by mnemonic identifier (empty for opcodes).
+    std::vector<std::function<void(Instruction &, mnemonic_t)>> pseudocodeProcessors;
     ///Skip over whitespaces.
     void ignoreWhitespaces() {do {tok.getNextToken();} while(tok.ttype == Tokenizer::WHITESPACE);}
     ///Call when the instruction takes a single register (B,C,D,E,H,L,M,A) as argument (and NOT register pairs)
-    void singleRegisterProc(Instruction &i, const char *);
+    void singleRegisterProc(Instruction &i, mnemonic_t);
     ///Call for STAX and LDAX instructions which accept only BC and DE register pairs as arguments
-    void STAX_LDAX_Proc(Instruction &i, const char *);
+    void STAX_LDAX_Proc(Instruction &i, mnemonic_t);
     ///Call for instructions that take a single register pair as argument (BC, DE, HL or SP).
-    void registerPairProc(Instruction &i, const char *);
+    void registerPairProc(Instruction &i, mnemonic_t);
     ///Call for PUSH and POP that take a single register pair as argument (BC, DE, HL or PSW).
-    void stackProc(Instruction &i, const char *);
+    void stackProc(Instruction &i, mnemonic_t);
+
+    ///Postfix form of the expression being parsed.
+    std::vector<ExprItem> postfix;
+    ///Evaluation stack depth needed by postfix so far, and nesting depth of the parser.
+    unsigned depth, nesting;
+    ///Character constant ('A') at the current token? Such strings are numbers in expressions.
+    bool isCharacterConstant() const {return tok.ttype == Tokenizer::STRING && tok.token.size == 3u;}
+    ///Last token of the expression being parsed (the parser reads one token ahead).
+    Tokenizer lastToken;
+    ///Move on to the next token, remembering the current one in lastToken.
+    void nextToken() {lastToken = tok; ignoreWhitespaces();}
+    ///Append an item to postfix.
+    void append(ExprItem::Op op, uint_least32_t value = 0u);
+    ///Binary operator at the current token and its precedence (higher binds tighter); 0 if there is none.
+    int binaryOperator(ExprItem::Op &op) const;
+    ///Parse operands and binary operators of at least the given precedence.
+    void parseBinary(int minPrecedence);
+    ///Parse a unary expression (-x, +x, HIGH x, LOW x, NOT x or a primary).
+    void parseUnary();
+    ///Parse a number, a symbol, $ or a parenthesized expression.
+    void parsePrimary();
+    ///Parse an expression starting at the current token into postfix; the current token is its last token on return. Returns
+    ///true (and the value) if it is constant.
+    bool parseExpression(data16_t &value);
+    ///Parse an operand expression into i: constant ones are folded into i.operand, the others are kept in the expression arena
+    ///and evaluated during assembly.
+    void parseOperand(Instruction &i, bool isByte);
+    ///Parse an expression which must be constant.
+    data16_t parseConstant(bool isByte);
 };
 
 #include "processor.h"
 #include <unordered_map>
 #include <QObject>
 
-///Main assembler class. This uses LineTranslator and assembles all instruction lines and puts executable bytecode into processor
-///memory.
-class Assembler : public QObject
+///One line of source as seen by the assembler: either a line of the source itself or a line produced by a macro expansion.
+struct SourceLine {
+    ///Text of the line, without its newline. Only valid until the next line is read.
+    const char *text;
+    ///Number of characters in text.
+    size_t length;
+    ///Line number in the source. Expanded lines have the number of the line which started the expansion.
+    unsigned lineNumber;
+    ///Offset of the line (or of the line which started the expansion) from the start of the source.
+    size_t offset;
+    ///Produced by a macro expansion (MACRO, REPT or IRP) or read from an included file?
+    bool expanded;
+    ///Name of the included file the line was read from (as written in INCLUDE) and its line number there; nullptr if none.
+    const char *file;
+    unsigned fileLineNumber;
+
+    ///Error at the given column and position (both counted within text) of this line. Errors in expanded lines are reported at
+    ///the start of the line which started the expansion.
+    SyntaxError error(unsigned column, int position, const std::string &what) const {
+        if(file != nullptr)
+            return SyntaxError(lineNumber, 0u, (int)offset, what + " (in " + file + " line " + unsignedNumber(fileLineNumber) + ")");
+        if(expanded) return SyntaxError(lineNumber, 0u, (int)offset, what + " (in macro expansion)");
+        return SyntaxError(lineNumber, column, (int)offset + position, what);
+    }
+};
+
+///Handles the preprocessor directives (MACRO/ENDM, REPT, IRP, IF/ELSE/ENDIF and INCLUDE) and hands the assembler one line at a
+///time. Nothing is expanded ahead of time: the lines of a macro are substituted as they are read, so an expansion costs no more
+///memory than its definition. Included files are read like macros without parameters.
+///Errors are passed to report and the preprocessor carries on, so that one run finds every error: a directive in error is
+///ignored, except that blocks and IFs are still opened (and then skipped) so that their ENDM or ENDIF still match.
+class Preprocessor {
+public:
+    ///Evaluates the expression which starts at the given offset of a line (the operand of IF or REPT) into value. Expressions
+    ///may only use symbols defined above them. Returns false if the expression is in error (which it reports itself). Set by
+    ///the assembler.
+    std::function<bool(const SourceLine &, size_t, data16_t &)> evaluate;
+    ///Called with every error found. Set by the assembler.
+    std::function<void(const SyntaxError &)> report;
+    ///Called with every line which nextLine() reads but does not return (directives, macro definitions and invocations, and
+    ///skipped lines), so that they can be listed. May be empty.
+    std::function<void(const SourceLine &)> consumed;
+    ///Constructor
+    Preprocessor();
+    ///Start reading another source buffer, forgetting all macros (but not the included files read so far). The buffer is read
+    ///in place and must outlive the run.
+    void reset(const char *source, size_t length);
+    ///Read the next line to assemble into line. Returns false at the end of the source.
+    bool nextLine(SourceLine &line);
+private:
+    ///Lines of a MACRO, REPT or IRP block, and the names of its parameters; or the lines of an included file, and its name.
+    struct Block {
+        std::vector<std::string> params;
+        std::vector<std::string> lines;
+        std::string file;
+    };
+    ///An included file, split into lines. Kept across runs, and read again only if the file changes.
+    struct IncludedFile {
+        ///Modification time (milliseconds since the epoch) and size of the file when it was read
+        qint64 modified, size;
+        std::shared_ptr<const Block> block;
+    };
+    ///A block being expanded.
+    struct Frame {
+        ///Block being expanded
+        std::shared_ptr<const Block> block;
+        ///Index of the next line of the block
+        size_t next;
+        ///Values of the parameters of the block
+        std::vector<std::string> args;
+        ///Values of the parameter of an IRP block, one per repetition
+        std::vector<std::string> values;
+        ///Current repetition and number of repetitions
+        size_t repetition, repetitions;
+        ///Line which started the expansion
+        unsigned lineNumber;
+        size_t offset;
+    };
+    ///An IF whose ENDIF has not been read yet.
+    struct Condition {
+        ///Are lines assembled at the moment? Has a branch been assembled (or is the whole IF skipped)?
+        bool active, taken;
+        ///Are lines around the IF assembled? Has ELSE been read?
+        bool parentActive, sawElse;
+        ///Number of frames when the IF was read (an IF must end in the block it started in).
+        size_t frame;
+        ///Line of the IF
+        unsigned lineNumber;
+        size_t offset;
+    };
+    ///Deepest nesting of expansions (also stops a macro which invokes itself).
+    static const size_t MAX_NESTING = 64u;
+
+    ///Source buffer (not owned), its length, the offset of its next line and the number of that line.
+    const char *source;
+    size_t sourceLength, position;
+    unsigned lineNumber;
+    ///Included files read so far, keyed by their absolute paths.
+    std::unordered_map<std::string, IncludedFile> files;
+    ///Macros defined so far, keyed by their upper-case names.
+    std::unordered_map<std::string, std::shared_ptr<const Block>> macros;
+    ///Expansions in progress, innermost last.
+    std::vector<Frame> frames;
+    ///Open IFs, innermost last.
+    std::vector<Condition> conditions;
+    ///Directive whose block is being read (MACRO, REPT or IRP), or nullptr. Blocks may contain other blocks; nesting counts them.
+    const opcode *collecting;
+    unsigned nesting;
+    ///Block being read, the name of the macro, and the line which started the block.
+    std::shared_ptr<Block> collected;
+    std::string collectedName;
+    SourceLine collectedStart;
+    ///Repetitions of a REPT block, or values of an IRP block, being read.
+    size_t collectedRepetitions;
+    std::vector<std::string> collectedValues;
+    ///Text of the last expanded line.
+    std::string buffer;
+    ///Scratch string for macro name lookups.
+    std::string key;
+    ///Tokenizer for the line being classified.
+    Tokenizer scan;
+    ///Results of classify(): the macro invoked by the line, its name, the label before the directive or invocation (empty if
+    ///none), and the offset of the operands in the line.
+    std::shared_ptr<const Block> invoked;
+    TokenView name, label;
+    size_t operands;
+
+    ///Read the next line from the source or from the innermost expansion, without looking at it. Returns false at the end of the source.
+    bool readLine(SourceLine &line);
+    ///Find out whether line is a directive (the directive is returned) or a macro invocation (nullptr is returned and invoked is
+    ///set). Other lines also give nullptr. A MACRO without a name gets an empty name (and is not defined at its ENDM).
+    const opcode *classify(const SourceLine &line);
+    ///Skip to the next token of scan which is not whitespace.
+    void skipWhitespaces() {do {scan.getNextToken();} while(scan.ttype == Tokenizer::WHITESPACE);}
+    ///Macro of the given name; nullptr if there is none.
+    std::shared_ptr<const Block> findMacro(const TokenView &name);
+    ///Split a list of macro arguments at the commas which are not inside quotes, parentheses or <>. Each value is trimmed and
+    ///loses its outer <>. The list ends at a ';' comment.
+    static void splitArguments(const char *text, size_t length, std::vector<std::string> &values);
+    ///Handle a directive read while lines are assembled.
+    void directive(const opcode *code, const SourceLine &line);
+    ///Lines of the file named by the string at the current token of scan, from files if the file has not changed since;
+    ///nullptr (after reporting why) if it cannot be read.
+    std::shared_ptr<const Block> includeFile(const SourceLine &line);
+    ///Handle IF, ELSE or ENDIF. These are followed even while lines are skipped.
+    void condition(const opcode *code, const SourceLine &line);
+    ///Start expanding a block (lineNumber and offset are those of the frame). Returns false (and abandons all expansions) if
+    ///expansions are nested too deeply.
+    bool expand(const std::shared_ptr<const Block> &block, const SourceLine &line, std::vector<std::string> &&args,
+                std::vector<std::string> &&values, size_t repetitions);
+    ///Report an error at the current token of scan.
+    void error(const SourceLine &line, const std::string &what) const {report(line.error(scan.columnNumber, scan.charNumber(), what));}
+};
+
+///Assembles source into a memory image of its own, reading lines through the Preprocessor and translating them with
+///LineTranslator. It has no processor, no signals and no global state: any number of these may run at once on different threads.
+class BasicAssembler
 {
-    Q_OBJECT
     ///Instruction processors respective for each pseudocode.
     std::unordered_map<const opcode *, std::function<void(Instruction &, memaddr_t &)>> pseudocodeProcessors;
-    ///Processor for which to assemble.
-    Processor *processor;
+    ///Result of translating one source line, cached by the text of the line.
+    struct CachedLine {
+        ///Text of the line (compared on lookup; the hash alone is not trusted).
+        std::string text;
+        ///Translated instruction (valid if error is empty). lineNumber is not meaningful here; label ids and DATA bytes refer to
+        ///the current pool and arena.
+        Instruction instruction;
+        ///Syntax error message if the line failed to translate; empty otherwise.
+        std::string error;
+        ///Column and offset (from the start of the line) of the syntax error.
+        unsigned errorColumn; int errorPosition;
+        ///Assembly run in which this entry was last used; stale entries are dropped after each run.
+        unsigned generation;
+        ///Constructor (an entry that matches nothing yet)
+        CachedLine() : errorColumn(0u), errorPosition(0), generation(0u) {}
+    };
+    ///Translated lines keyed by a hash of their text. Only lines whose text changed since the last run are translated again.
+    std::unordered_map<uint_fast64_t, CachedLine> lineCache;
+    ///Number of the current assembly run.
+    unsigned generation;
+    ///Label names of cached lines and of instructions. Shared with debug table models; replaced (never cleared) when it grows
+    ///too large, so that models keep a valid pool.
+    std::shared_ptr<StringPool> pool;
+    ///DATA bytes of cached lines. Append-only; reset together with the pool and the line cache.
+    std::vector<data8_t> arena;
+    ///Operand expressions of cached lines. Append-only, like arena.
+    std::vector<ExprItem> expressions;
+    ///Symbols of the last assembly, keyed by the case-insensitive keys of the pool.
+    SymbolTable symbols;
+    ///Tokenizer and translator reused for every line (constructing a translator is not cheap).
+    Tokenizer lineTokenizer;
+    LineTranslator translator;
+    ///Expands macros and conditionals of the source, one line at a time.
+    Preprocessor preprocessor;
+    ///Line number which wrote each byte of image (0 if none); used to detect overlapping code and data.
+    std::vector<unsigned> owner;
+    ///Module produced by the current run, or nullptr if the run assembles into the image only.
+    ObjectModule *object;
+    ///Listing written by the current run, or nullptr.
+    Listing *listing;
+    ///Errors found by the current run.
+    std::vector<SyntaxError> *diagnostics;
+protected:
+    ///Memory image built by the last run. Bytes not written by the program are 0.
+    std::vector<data8_t> image;
+    ///Blocks reserved by DS in the last run, as [start, end) address ranges. Their bytes in image are not part of the program.
+    std::vector<std::pair<memsize_t, memsize_t>> reserved;
+    ///Called once per source line while assembling; returning true abandons the run. Polls cancelled.
+    virtual bool poll() {return cancelled && cancelled();}
+    ///Called at the end of a run without errors which did not assemble into a module, once image is complete. Does nothing.
+    virtual void commit() {}
 public:
-    ///Input source for the assembler.
-    std::istream *in;
-    ///Debugging information generated by the last assembly done.
+    ///Input source for the assembler. The tokenizer reads it in place, so it must not be changed while assembly runs.
+    std::string source;
+    ///Debugging information generated by the last assembly done, in source order.
     std::vector<Instruction> instructions;
+    ///Pool holding the label names of instructions.
+    std::shared_ptr<const StringPool> getStringPool() const {return pool;}
+    ///Symbols defined (and referred to) by the last assembly.
+    const SymbolTable &getSymbols() const {return symbols;}
+    ///Memory image of the last assembly (MEMORY_SIZE bytes); only meaningful if it had no errors.
+    const std::vector<data8_t> &getImage() const {return image;}
+    ///Blocks reserved by DS in the last assembly, as [start, end) address ranges.
+    const std::vector<std::pair<memsize_t, memsize_t>> &getReserved() const {return reserved;}
+    ///Polled once per source line while assembling. If set and it returns true, the run is abandoned without committing
+    ///anything. Used to cancel a background run once the source it is checking has been edited again.
+    std::function<bool()> cancelled;
     ///Constructor.
-    explicit Assembler(Processor *);
+    BasicAssembler();
+    ///Destructor.
+    virtual ~BasicAssembler() = default;
+    ///Forget all cached lines (the next assembly translates every line again).
+    void clearCache();
+    ///Assemble source into the image and commit it, reporting problems in diagnostics instead of emitting signals. Returns false
+    ///if the run was cancelled. Does not throw exceptions. A line in error is reported and skipped, and assembly goes on with the
+    ///next line, so that one run finds all the errors (in line order); nothing is committed if there are any.
+    ///If module is given, the source is assembled into it instead (see ObjectModule), and nothing is committed. Symbols which
+    ///are not defined are then imported from other modules, and all global labels and EQU symbols are exported. The module is
+    ///only valid if there are no diagnostics.
+    ///If listing is given, the listing and symbol file are written into it as the source is assembled (see Listing).
+    bool runAssembly(std::vector<SyntaxError> &diagnostics, ObjectModule *module = nullptr, Listing *listing = nullptr);
+private:
+    ///Translate one line of source through the line cache into i. Returns false (after reporting the error) if the line is in
+    ///error; errors are cached along with the lines, so an unchanged line in error is not translated again either.
+    bool translateLine(const SourceLine &line, Instruction &i);
+    ///Do the actual assembly, adding errors to diagnostics. Returns false if cancelled.
+    bool doAssembly();
+    ///Copy the file named by an INCBIN line into image at its address (the file is mapped, not read), and set its dataLength.
+    ///Returns false (after reporting the error) if the file cannot be read.
+    bool includeBinary(Instruction &i, const SourceLine &line);
+    ///Add an error to diagnostics.
+    void report(const SyntaxError &ex) {diagnostics->push_back(ex);}
+    ///Write the bytes of an instruction into image.
+    void emitInstruction(const Instruction &i);
+    ///Fill object from the results of the run: sections of image (except reserved blocks), and exports.
+    void buildObject(bool relocatable);
+};
+
+///Everything produced by assembleSource().
+struct AssemblyResult {
+    ///Memory image (MEMORY_SIZE bytes); bytes not written by the program are 0. Only meaningful if there are no diagnostics.
+    std::vector<data8_t> image;
+    ///Blocks reserved by DS, as [start, end) address ranges.
+    std::vector<std::pair<memsize_t, memsize_t>> reserved;
+    ///Debugging information, in source order.
+    std::vector<Instruction> instructions;
+    ///Pool holding the label names of instructions and symbols.
+    std::shared_ptr<const StringPool> pool;
+    ///Symbols defined (and referred to) by the source.
+    SymbolTable symbols;
+    ///Errors, in line order.
+    std::vector<SyntaxError> diagnostics;
+};
+///Assemble length characters of source into result. Reentrant: it uses no QObject and no shared mutable state (INCLUDE and
+///INCBIN names are still relative to the working directory), so it may be called from any number of threads at once.
+void assembleSource(const char *source, size_t length, AssemblyResult &result);
+
+///Main assembler class. Assembles source like BasicAssembler, then puts the executable bytecode into processor memory, and
+///drives assembly from the GUI through signals and slots. An Assembler without a processor only checks the source (used for
+///background assembly on a worker thread).
+class Assembler : public QObject, public BasicAssembler
+{
+    Q_OBJECT
+    ///Processor for which to assemble.
+    Processor *processor;
+protected:
+    ///Keeps the GUI responsive while assembling on its thread, then polls cancelled.
+    bool poll(); //override
+    ///Write the bytes of image that differ from processor memory, except for reserved blocks (one contiguous block, and one
+    ///memoryBlockUpdated() signal, between two reserved blocks).
+    void commit(); //override
+public:
+    ///Constructor. proc may be nullptr, in which case nothing is ever written to memory.
+    explicit Assembler(Processor *proc);
     ///Destructor (required for interop with Qt.)
     virtual ~Assembler() = default;
+    ///Listing and symbol file written by the last assemble() call (see Listing::save()); only complete if it finished
+    ///successfully.
+    Listing assemblyListing;
 private:
-    ///Do the actual assembly. May throw SyntaxError.
-    void doAssembly();
+    ///Write the bytes of image in [first, last) that differ from processor memory, as one block.
+    void commitRange(memsize_t first, memsize_t last);
 public slots:
-    ///Slot to start assembly. Does not throw exceptions. Either assemblyFinished() or assemblyError() signals will be fired
-    ///according to the result of the assembly.
+    ///Slot to start assembly. Does not throw exceptions. Either assemblyFinished() or assemblyError() and assemblyErrors()
+    ///signals will be fired according to the result of the assembly.
     void assemble();
 signals:
     ///Signals that the last assemble() slot call finished successfully.
     void assemblyFinished();
-    ///Signals that the last assemble() call resulted in an error. Processor memory is not changed; but instructions vector is
-    ///invalid (and may be cleared).
+    ///Signals that the last assemble() call resulted in an error (the first one, in line order). Processor memory is not
+    ///changed; but instructions vector is invalid (and may be cleared).
     void assemblyError(SyntaxError ex);
+    ///Signals every error of the last assemble() call, in line order; fired right after assemblyError().
+    void assemblyErrors(std::vector<SyntaxError> diagnostics);
 };
 
 ///Call this in main(). Qt needs to know about these types to pass them through signals and slots.
 #define ASSEMBLER_H_registerHeaderMetaTypes() {\
     qRegisterMetaType<Instruction>("Instruction");\
     qRegisterMetaType<SyntaxError>("SyntaxError");\
+    qRegisterMetaType<std::vector<SyntaxError>>("std::vector<SyntaxError>");\
+    qRegisterMetaType<std::string>("std::string");\
     /*qRegisterMetaType<Tokenizer>("Tokenizer");*/\
 }
 
@@ -0,0 +1,59 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "backgroundassembler.h"
+
+BackgroundAssembler::BackgroundAssembler(QTextDocument *document, QObject *parent) : QObject(parent), document(document),
+    worker(new Assembler(nullptr)), latest(0u) {
+    debounce.setSingleShot(true);
+    debounce.setInterval(400);
+    worker->moveToThread(&workerThread);
+    connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(document, &QTextDocument::contentsChanged, this, &BackgroundAssembler::documentChanged);
+    connect(&debounce, &QTimer::timeout, this, &BackgroundAssembler::checkNow);
+    //Runs on the worker thread (worker is the context object).
+    connect(this, &BackgroundAssembler::__fireCheck, worker, [this](unsigned request, std::string source) {
+        if(request != latest.load()) return; //overtaken while queued
+        worker->source.swap(source);
+        worker->cancelled = [this, request]() {return latest.load() != request;};
+        std::vector<SyntaxError> diagnostics;
+        if(worker->runAssembly(diagnostics)) emit __checkFinished(request, diagnostics);
+    });
+    //Back on this (GUI) thread.
+    connect(this, &BackgroundAssembler::__checkFinished, this, [this](unsigned request, std::vector<SyntaxError> diagnostics) {
+        if(request == latest.load()) emit diagnosticsReady(diagnostics);
+    });
+    workerThread.start(QThread::LowPriority);
+}
+BackgroundAssembler::~BackgroundAssembler() {
+    latest++; //cancel
+    workerThread.quit();
+    workerThread.wait();
+}
+void BackgroundAssembler::checkNow() {
+    debounce.stop();
+    const unsigned request = ++latest;
+    emit __fireCheck(request, document->toPlainText().toStdString());
+}
+void BackgroundAssembler::documentChanged() {
+    latest++; //cancel a check of the previous contents
+    debounce.start();
+}
@@ -0,0 +1,77 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef BACKGROUNDASSEMBLER_H
+#define BACKGROUNDASSEMBLER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QTextDocument>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "assembler.h"
+
+///Assembles the contents of a document continuously on a worker thread, to report syntax errors while the user types.
+///Checks are debounced: each edit restarts a timer, and the document is snapshotted only when it runs out. An edit also
+///cancels a check still in progress. The worker has its own Assembler with no Processor attached, so processor memory is
+///never touched; the program is committed only by an explicit assembly (MainWindow::assemble()).
+class BackgroundAssembler : public QObject
+{
+    Q_OBJECT
+public:
+    ///Constructor. document must outlive this object.
+    BackgroundAssembler(QTextDocument *document, QObject *parent = nullptr);
+    ///Destructor. Cancels any running check and waits for the worker thread to finish.
+    virtual ~BackgroundAssembler();
+    ///Set the idle time (in milliseconds) after the last edit before a check starts.
+    void setDelay(int msec) {debounce.setInterval(msec);}
+public slots:
+    ///Check the document now (still on the worker thread).
+    void checkNow();
+private slots:
+    ///The document was edited.
+    void documentChanged();
+signals:
+    ///Diagnostics for the current contents of the document; empty if it assembles cleanly. Results of checks which were
+    ///overtaken by later edits are never reported.
+    void diagnosticsReady(std::vector<SyntaxError> diagnostics);
+
+    //WARNING: TREAT THE FOLLOWING AS PRIVATE API
+    ///Fire event to have the worker check a snapshot of the source.
+    void __fireCheck(unsigned request, std::string source);
+    ///Fired (from the worker thread) when a check completed.
+    void __checkFinished(unsigned request, std::vector<SyntaxError> diagnostics);
+private:
+    ///Document being checked.
+    QTextDocument * const document;
+    ///Thread the worker lives on.
+    QThread workerThread;
+    ///Assembler used on the worker thread. Deleted when the thread finishes.
+    Assembler * const worker;
+    ///Debounce timer; a check starts when it runs out.
+    QTimer debounce;
+    ///Number of the latest request. Bumped on every edit, which is what cancels a check in progress.
+    std::atomic<unsigned> latest;
+};
+
+#endif // BACKGROUNDASSEMBLER_H
@@ -51,6 +51,11 @@ typedef data8_t         ioaddr_t;
 /// Number of I/O ports supported by this implementation (all 256).
 #define IO_PORT_SIZE    256
 
+/// Type for counting processor clock cycles (T-states). 64 bits wide so that it practically never overflows.
+typedef uint_fast64_t   cycles_t;
+/// Largest value representable by cycles_t; used to mean "never".
+#define CYCLES_MAX      ((cycles_t)UINT_FAST64_MAX)
+
 /// Type for the flag register, exactly the same as data8_t.
 typedef data8_t         flags_t;
 /// Sign flag (S) at D7 of flag register.
@@ -142,6 +147,7 @@ inline void registerHeaderMetaTypes() {
     qRegisterMetaType<memsize_t>("memsize_t");
     qRegisterMetaType<flags_t>("flags_t");
     qRegisterMetaType<ioaddr_t>("ioaddr_t");
+    qRegisterMetaType<cycles_t>("cycles_t");
 }
 }
 
@@ -20,15 +20,36 @@ furnished to do so, subject to the following conditions:
     OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
     SOFTWARE.*/
 #include "debugtable.h"
+#include "listing.h"
 #include <QVector>
 #include <QFont>
+#include <QFile>
 #include <algorithm>
 
 //DebugTable
 
-DebugTableModel::DebugTableModel(QObject *parent, const std::vector<Instruction> &vec)
-    : QAbstractTableModel(parent), list(vec) {
+DebugTableModel::DebugTableModel(QObject *parent, const std::vector<Instruction> &vec, std::shared_ptr<const StringPool> pool)
+    : QAbstractTableModel(parent), list(vec), pool(pool) {
     std::stable_sort(list.begin(), list.end(), InstructionAddressComparator()); //We show rows sorted on instruction address.
+    //Address and line lookups. If two instructions share an address or a line, the first row (the lowest address) wins.
+    locations.assign(MEMORY_SIZE, Location{-1, 0u});
+    unsigned lastLine = 0u;
+    for(const Instruction &i : list) lastLine = std::max(lastLine, i.lineNumber);
+    lineAddresses.assign(lastLine + 1u, -1);
+    for(size_t row = 0; row < list.size(); row++) {
+        const Instruction &i = list[row];
+        if(locations[i.address].row == -1) locations[i.address] = Location{(int)row, i.lineNumber};
+        if(lineAddresses[i.lineNumber] == -1) lineAddresses[i.lineNumber] = i.address;
+    }
+}
+DebugTableModel *DebugTableModel::fromListing(const QString &path, QObject *parent) {
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return nullptr;
+    const QByteArray text = file.readAll();
+    std::shared_ptr<StringPool> pool = std::make_shared<StringPool>();
+    std::vector<Instruction> instructions;
+    if(!Listing::parse(text.constData(), (size_t)text.size(), *pool, instructions)) return nullptr;
+    return new DebugTableModel(parent, instructions, pool);
 }
 int DebugTableModel::rowCount(const QModelIndex &parent) const {return parent.isValid() ? 0 : list.size();} //override
 int DebugTableModel::columnCount(const QModelIndex &parent) const {return parent.isValid() ? 0 : 7;} //override
@@ -38,10 +59,10 @@ QVariant DebugTableModel::data(const QModelIndex &index, int role) const {//over
     case Qt::DisplayRole:
         switch(index.column()) {
         case 0: return QVariant(getHex16(list[index.row()].address));
-        case 1: return QVariant(QString::fromStdString(list[index.row()].label));
+        case 1: return QVariant(labelText(list[index.row()].label));
         case 2: return QVariant(QString(list[index.row()].code->name));
         case 3:
-            if(!list[index.row()].toLabel.empty()) return QVariant(QString::fromStdString(list[index.row()].toLabel));
+            if(list[index.row()].toLabel != 0u) return QVariant(labelText(list[index.row()].toLabel));
             switch(list[index.row()].code->bytesRequired) {
             case 1: return QVariant(QString(""));
             case 2: return QVariant(getHex8(list[index.row()].operand & 0xFFu));
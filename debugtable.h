@@ -31,6 +31,7 @@ furnished to do so, subject to the following conditions:
 #include <QBrush>
 #include <QColor>
 #include <vector>
+#include <memory>
 #include "commdefs.h"
 #include "assembler.h"
 
@@ -63,6 +64,20 @@ class DebugTableModel : public QAbstractTableModel {
         default: return QVariant();
         }
     }
+    ///Where the instruction starting at an address is: its row, and its line in the source.
+    struct Location {
+        ///Row in list; -1 if no instruction starts at the address.
+        int row;
+        ///Line number of the instruction; 0 if none.
+        unsigned lineNumber;
+    };
+    ///Location of every address (MEMORY_SIZE entries), built once with the model so that following the program counter costs one
+    ///array load.
+    std::vector<Location> locations;
+    ///Address of the first instruction (the lowest address) of each source line; -1 for lines without instructions.
+    std::vector<int_least32_t> lineAddresses;
+    ///Text of an interned label; empty if there is no pool.
+    QString labelText(string_id_t id) const {return pool ? QString::fromUtf8(pool->str(id), (int)pool->length(id)) : QString();}
     ///Construct brush (background texture) for highlighting. See highlightedIndex.
     static QBrush constructHighlightBrush() {
         QBrush brush;
@@ -71,8 +86,13 @@ class DebugTableModel : public QAbstractTableModel {
         return brush;
     }
 public:
-    ///Constructor. vec is the vector holding all Instructions to be viewed by the table referencing this model.
-    explicit DebugTableModel(QObject *parent = nullptr, const std::vector<Instruction> &vec = std::vector<Instruction>());
+    ///Constructor. vec is the vector holding all Instructions to be viewed by the table referencing this model; pool is the
+    ///string pool their label identifiers refer to.
+    explicit DebugTableModel(QObject *parent = nullptr, const std::vector<Instruction> &vec = std::vector<Instruction>(),
+                             std::shared_ptr<const StringPool> pool = nullptr);
+    ///Model showing the instructions of a listing file (see Listing), so that the program can be browsed without assembling
+    ///its source again. Returns nullptr if the file cannot be read or is not a listing.
+    static DebugTableModel *fromListing(const QString &path, QObject *parent = nullptr);
     ///Number of rows = list.size()
     int rowCount(const QModelIndex &parent = QModelIndex()) const; //override
     ///Number of columns = 7.
@@ -81,10 +101,18 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const; //override
     ///Data for a header (row or column). Calls either rowHeader or columnHeader.
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const; //override
+    ///Row of the instruction starting at address; -1 if none.
+    int rowOf(memaddr_t address) const {return locations[address].row;}
+    ///Source line of the instruction starting at address; 0 if none.
+    unsigned lineOf(memaddr_t address) const {return locations[address].lineNumber;}
+    ///Address of the first instruction of a source line; -1 if the line has none.
+    int_least32_t addressOfLine(unsigned lineNumber) const {return lineNumber < lineAddresses.size() ? lineAddresses[lineNumber] : -1;}
     ///Return current highlighted index; may be -1.
     int getHighlighedIndex() const {return highlightedIndex;}
     ///The list displayed by this model. Although this is NOT const; it should be treated as such.
     std::vector<Instruction> list; //Do not change. Construct a new object everytime this is changed.
+    ///Pool holding the label names of list. Shared so that it outlives an assembler cache reset.
+    std::shared_ptr<const StringPool> pool;
 public slots:
     ///Set current highlighted index. Set to -1 if highlighting is to be disabled.
     void setHighlightedIndex(int index);
@@ -0,0 +1,166 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "disassembler.h"
+#include "processor.h"
+#include <algorithm>
+#include <cstring>
+#include <QFile>
+
+///What execution does after an instruction.
+enum Flow {
+    ///Goes on with the next instruction
+    NEXT,
+    ///Goes to the target only (JMP)
+    JUMP,
+    ///Goes to the target or the next instruction (conditional jumps, calls and RST)
+    BRANCH,
+    ///Goes nowhere that can be followed (RET, PCHL and HLT)
+    STOP
+};
+///Flow of control after the opcode code; target is set for JUMP and BRANCH (from the operand for 3-byte instructions).
+static Flow flowOf(data8_t code, data16_t operand, data16_t &target) {
+    if(code == 0xC3u) {target = operand; return JUMP;} //JMP
+    if((code & 0xC7u) == 0xC2u || (code & 0xC7u) == 0xC4u || code == 0xCDu) {target = operand; return BRANCH;} //Jcc, Ccc, CALL
+    if((code & 0xC7u) == 0xC7u) {target = code & 0x38u; return BRANCH;} //RST n calls 8*n
+    if(code == 0xC9u || code == 0xE9u || code == 0x76u) return STOP; //RET, PCHL, HLT
+    return NEXT;
+}
+///Hexadecimal literal with the given number of digits, as the assembler reads it (example "0FFH").
+static std::string hexLiteral(unsigned value, unsigned digits) {
+    std::string s = unsignedNumber(value, 16);
+    if(s.length() < digits) s.insert(0, digits - s.length(), '0');
+    if(!std::isdigit((unsigned char)s[0])) s.insert(0, 1, '0');
+    return s + 'H';
+}
+
+Disassembler::Disassembler() : image(MEMORY_SIZE, 0u), kinds(MEMORY_SIZE, DATA), pool(std::make_shared<StringPool>()) {}
+void Disassembler::load(const Processor &processor) {
+    for(memsize_t k = 0; k < MEMORY_SIZE; k++) image[k] = processor.getMemoryByte((memaddr_t)k);
+}
+void Disassembler::load(const data8_t *bytes, memsize_t length, memaddr_t address) {
+    for(memsize_t k = 0; k < length; k++) image[(address + k) & 0xFFFFu] = bytes[k];
+}
+bool Disassembler::loadFile(const QString &path, memaddr_t address, memsize_t &length) {
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return false;
+    const qint64 size = file.size();
+    if(size > (qint64)MEMORY_SIZE) return false;
+    length = (memsize_t)size;
+    if(size == 0) return true;
+    const uchar *const data = file.map(0, size);
+    if(data == nullptr) return false;
+    load(data, length, address);
+    file.unmap(const_cast<uchar *>(data));
+    return true;
+}
+const opcode *Disassembler::decode(memsize_t address, memsize_t last) {
+    const opcode *const op = opcodesByCode[image[address]];
+    if(op == nullptr || address + op->bytesRequired > last) return nullptr;
+    //Bytes already taken by another instruction (execution jumping into the middle of one) are not decoded again.
+    for(memsize_t k = 1; k < op->bytesRequired; k++) if(kinds[address + k] != DATA) return nullptr;
+    kinds[address] = INSTRUCTION;
+    for(memsize_t k = 1; k < op->bytesRequired; k++) kinds[address + k] = OPERAND;
+    return op;
+}
+void Disassembler::disassemble(memsize_t first, memsize_t last, Mode mode, const std::vector<memaddr_t> &entries) {
+    last = std::min(last, MEMORY_SIZE);
+    std::fill(kinds.begin(), kinds.end(), (data8_t)DATA);
+    if(mode == LINEAR_SWEEP) {
+        for(memsize_t address = first; address < last;) {
+            const opcode *const op = decode(address, last);
+            address += op != nullptr ? op->bytesRequired : 1u;
+        }
+    }
+    else {
+        std::vector<memsize_t> pending(entries.begin(), entries.end());
+        if(pending.empty()) pending.push_back(first);
+        while(!pending.empty()) {
+            memsize_t address = pending.back(); pending.pop_back();
+            //Follow the flow from here until it stops or runs into code which is already known.
+            while(address >= first && address < last && kinds[address] == DATA) {
+                const opcode *const op = decode(address, last);
+                if(op == nullptr) break;
+                data16_t target = 0u;
+                const Flow flow = flowOf(op->code, PACK(image[(address + 2u) & 0xFFFFu], image[(address + 1u) & 0xFFFFu]), target);
+                if(flow == JUMP || flow == BRANCH) pending.push_back(target);
+                if(flow == JUMP || flow == STOP) break;
+                address += op->bytesRequired;
+            }
+        }
+    }
+    build(first, last);
+}
+void Disassembler::build(memsize_t first, memsize_t last) {
+    instructions.clear(); source.clear();
+    pool = std::make_shared<StringPool>(); //the old pool stays alive for as long as a model still holds on to it
+    //Label every instruction which is the target of a jump, call or RST.
+    std::vector<string_id_t> labels(MEMORY_SIZE, 0u);
+    for(memsize_t address = first; address < last; address++) {
+        if(kinds[address] != INSTRUCTION) continue;
+        const data8_t code = image[address];
+        data16_t target = 0u;
+        const Flow flow = flowOf(code, PACK(image[(address + 2u) & 0xFFFFu], image[(address + 1u) & 0xFFFFu]), target);
+        if((flow != JUMP && flow != BRANCH) || kinds[target] != INSTRUCTION || labels[target] != 0u) continue;
+        std::string name = unsignedNumber(target, 16);
+        name.insert(0, 5u - name.length(), '0'); name[0] = 'L'; //L and four digits
+        labels[target] = pool->intern(name.data(), name.length());
+    }
+    //Lines of source: labels go in the first columns, instructions and data after them.
+    static const size_t LABEL_WIDTH = 8u, DATA_PER_LINE = 8u;
+    unsigned lineNumber = 0u;
+    const auto startLine = [&](string_id_t label) {
+        lineNumber++;
+        const size_t start = source.length();
+        if(label != 0u) {source += pool->str(label); source += ':';}
+        source.append(std::max<size_t>(start + LABEL_WIDTH - source.length(), 1u), ' ');
+    };
+    startLine(0u); source += "ORG " + hexLiteral((unsigned)first, 4u) + '\n';
+    for(memsize_t address = first; address < last;) {
+        if(kinds[address] != INSTRUCTION) {
+            //A run of data bytes, up to the next instruction.
+            startLine(0u); source += "DB ";
+            for(size_t k = 0; k < DATA_PER_LINE && address < last && kinds[address] != INSTRUCTION; k++, address++) {
+                if(k != 0u) source += ", ";
+                source += hexLiteral(image[address], 2u);
+            }
+            source += '\n';
+            continue;
+        }
+        Instruction i;
+        i.code = opcodesByCode[image[address]];
+        i.address = (memaddr_t)address; i.label = labels[address];
+        if(i.code->bytesRequired == 2) i.operand = image[address + 1u];
+        else if(i.code->bytesRequired == 3) i.operand = PACK(image[address + 2u], image[address + 1u]);
+        startLine(i.label); i.lineNumber = lineNumber;
+        source += i.code->name;
+        if(i.code->bytesRequired >= 2) {
+            //"MVI A, 05H" but "JMP 0800H" (operands follow the register, if there is one).
+            source += std::strchr(i.code->name, ' ') != nullptr ? ", " : " ";
+            data16_t target = 0u;
+            if(i.code->bytesRequired == 3 && flowOf(i.code->code, i.operand, target) != NEXT) i.toLabel = labels[target];
+            source += i.toLabel != 0u ? std::string(pool->str(i.toLabel)) : hexLiteral(i.operand, i.code->bytesRequired == 2 ? 2u : 4u);
+        }
+        source += '\n';
+        instructions.push_back(i);
+        address += i.code->bytesRequired;
+    }
+}
@@ -0,0 +1,96 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <QString>
+#include "commdefs.h"
+#include "stringpool.h"
+#include "assembler.h"
+
+class Processor;
+
+///Turns a memory image back into instructions (for the debug table) and into source which assembles to the same bytes. Jump,
+///call and RST targets which are instructions get labels (L followed by the address, example "L0800"). Two modes:
+///
+///LINEAR_SWEEP decodes every byte of the range in order; bytes which are not an opcode (or an instruction cut off by the end
+///of the range) are data. It is fast, but data between instructions is decoded as code as well.
+///
+///RECURSIVE_DESCENT only decodes what execution can reach: starting from the entry points, it follows the flow of control
+///through jumps, calls and RSTs (both ways for conditional ones) until a JMP, RET, PCHL or HLT. Everything else is data.
+class Disassembler {
+public:
+    ///How code is told apart from data.
+    enum Mode {LINEAR_SWEEP, RECURSIVE_DESCENT};
+    ///Constructor (an image of zeros and no instructions)
+    Disassembler();
+    ///Copy the memory of a processor into the image.
+    void load(const Processor &processor);
+    ///Copy length bytes into the image at address (wrapping around at the end of memory).
+    void load(const data8_t *bytes, memsize_t length, memaddr_t address);
+    ///Read a binary (ROM) file into the image at address and set length to its size. Returns false if the file cannot be read or
+    ///is larger than the address space.
+    bool loadFile(const QString &path, memaddr_t address, memsize_t &length);
+    ///Disassemble the bytes of the image in [first, last). Entry points are only used by RECURSIVE_DESCENT; first is the only
+    ///one if none are given. Entry points outside the range are ignored.
+    void disassemble(memsize_t first, memsize_t last, Mode mode, const std::vector<memaddr_t> &entries = std::vector<memaddr_t>());
+    ///Instructions found by the last disassembly, in address order. lineNumber is the line of the instruction in getSource().
+    const std::vector<Instruction> &getInstructions() const {return instructions;}
+    ///Pool holding the labels of the instructions.
+    std::shared_ptr<const StringPool> getStringPool() const {return pool;}
+    ///Source of the last disassembly: an ORG, then the instructions, and DB lines for the data between them.
+    const std::string &getSource() const {return source;}
+    ///Memory image
+    const std::vector<data8_t> &getImage() const {return image;}
+    ///Did the last disassembly find an instruction starting at address?
+    bool isInstruction(memaddr_t address) const {return kinds[address] == INSTRUCTION;}
+private:
+    ///What each byte of the image was found to be.
+    enum Kind : data8_t {
+        ///Data, or outside the range
+        DATA,
+        ///First byte of an instruction
+        INSTRUCTION,
+        ///Second or third byte of an instruction
+        OPERAND
+    };
+    ///Decode the instruction at address into kinds, if it is one and fits before last. Returns its opcode, or nullptr.
+    const opcode *decode(memsize_t address, memsize_t last);
+    ///Build instructions, labels and source from kinds.
+    void build(memsize_t first, memsize_t last);
+
+    ///Memory image being disassembled (MEMORY_SIZE bytes)
+    std::vector<data8_t> image;
+    ///Kind of each byte of the image, as found by the last disassembly
+    std::vector<data8_t> kinds;
+    ///Instructions found by the last disassembly, in address order
+    std::vector<Instruction> instructions;
+    ///Pool holding the labels of the instructions
+    std::shared_ptr<StringPool> pool;
+    ///Source of the last disassembly
+    std::string source;
+};
+
+#endif // DISASSEMBLER_H
@@ -0,0 +1,165 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include <QString>
+#include <QVector>
+#include <QFont>
+#include <QBrush>
+#include <algorithm>
+#include "disassemblymodel.h"
+
+//DisassemblyModel
+const QColor DisassemblyModel::pc = QColor::fromRgbF(0.75, 0.25, 0.25, 0.5); //red, as in the memory table
+
+DisassemblyModel::DisassemblyModel(Processor *proc, QObject *parent) : QAbstractTableModel(parent), processor(proc),
+    pages(PAGE_COUNT), firstRow(PAGE_COUNT + 1u, 0) {
+    connect(processor, &Processor::memoryBlockUpdated, this, &DisassemblyModel::memoryBlockUpdated);
+    connect(processor, &Processor::programCounterChanged, this, &DisassemblyModel::pcChanged);
+    for(unsigned page = 0; page < PAGE_COUNT; page++) pages[page] = decode(page, page == 0u ? 0u : pages[page-1u].spill);
+    countRows();
+    oldPC = processor->getProgramCounter();
+}
+const opcode *DisassemblyModel::opcodeAt(memaddr_t address) const {
+    const opcode *const op = opcodesByCode[processor->getMemoryByte(address)];
+    return op != nullptr && (memsize_t)address + op->bytesRequired <= MEMORY_SIZE ? op : nullptr; //never wraps around
+}
+DisassemblyModel::Page DisassemblyModel::decode(unsigned page, data8_t start) const {
+    Page decoded; decoded.spill = 0u;
+    const memsize_t base = page * PAGE_SIZE;
+    for(memsize_t offset = start; offset < PAGE_SIZE;) {
+        decoded.rows.push_back((data8_t)offset);
+        const opcode *const op = opcodeAt((memaddr_t)(base + offset));
+        offset += op != nullptr ? op->bytesRequired : 1u; //bytes which are not an opcode take a row each
+        if(offset > PAGE_SIZE) decoded.spill = (data8_t)(offset - PAGE_SIZE);
+    }
+    return decoded;
+}
+void DisassemblyModel::countRows() {
+    for(unsigned page = 0; page < PAGE_COUNT; page++) firstRow[page + 1u] = firstRow[page] + (int)pages[page].rows.size();
+}
+void DisassemblyModel::replace(unsigned page, Page &decoded) {
+    Page &current = pages[page];
+    current.spill = decoded.spill;
+    if(current.rows == decoded.rows) {
+        //Same instructions, different bytes (or the same bytes written again).
+        emit dataChanged(createIndex(firstRow[page], 0), createIndex(firstRow[page + 1u] - 1, 5), QVector<int>(1, Qt::DisplayRole));
+        return;
+    }
+    //A page always has rows (an instruction takes up at most 2 bytes of the next page).
+    beginRemoveRows(QModelIndex(), firstRow[page], firstRow[page + 1u] - 1);
+    current.rows.clear(); countRows();
+    endRemoveRows();
+    beginInsertRows(QModelIndex(), firstRow[page], firstRow[page] + (int)decoded.rows.size() - 1);
+    current.rows.swap(decoded.rows); countRows();
+    endInsertRows();
+}
+void DisassemblyModel::update(unsigned first, unsigned last) {
+    for(unsigned page = first; page < PAGE_COUNT; page++) {
+        const data8_t start = page == 0u ? 0u : pages[page-1u].spill;
+        if(page > last && pages[page].rows.front() == start) break; //the pages after this one are unaffected
+        Page decoded = decode(page, start);
+        replace(page, decoded);
+    }
+}
+int DisassemblyModel::rowOf(memaddr_t address) const {
+    const std::vector<data8_t> &rows = pages[address / PAGE_SIZE].rows;
+    //Bytes before the first row of a page belong to the last row of the page before.
+    const std::vector<data8_t>::const_iterator it = std::upper_bound(rows.begin(), rows.end(), (data8_t)(address % PAGE_SIZE));
+    return firstRow[address / PAGE_SIZE] + (int)(it - rows.begin()) - 1;
+}
+memaddr_t DisassemblyModel::addressOf(int row) const {
+    const unsigned page = (unsigned)(std::upper_bound(firstRow.begin(), firstRow.end(), row) - firstRow.begin()) - 1u;
+    return (memaddr_t)(page * PAGE_SIZE + pages[page].rows[row - firstRow[page]]);
+}
+QVariant DisassemblyModel::columnHeader(int column, int role) {
+    static const char *columns[] = {"Address", "Instruction", "Operand", "B1", "B2", "B3"};
+    switch(role) {
+    case Qt::DisplayRole: return QVariant(QString(columns[column]));
+    case Qt::TextAlignmentRole: return QVariant(Qt::AlignCenter);
+    default: return QVariant();
+    }
+}
+QVariant DisassemblyModel::data(const QModelIndex &index, int role) const {//override
+    if(!index.isValid()) return QVariant(); //invalid. We return headers in headerData().
+    const memaddr_t address = addressOf(index.row());
+    const opcode *const op = opcodeAt(address);
+    const unsigned size = op != nullptr ? op->bytesRequired : 1u;
+    const data8_t b1 = processor->getMemoryByte((address + 1u) & 0xFFFFu), b2 = processor->getMemoryByte((address + 2u) & 0xFFFFu);
+    switch(role) {
+    case Qt::DisplayRole:
+        switch(index.column()) {
+        case 0: return QVariant(getHex16(address));
+        case 1: return QVariant(QString(op != nullptr ? op->name : "DB"));
+        case 2:
+            if(op == nullptr) return QVariant(getHex8(processor->getMemoryByte(address)));
+            return QVariant(size == 3u ? getHex16(PACK(b2, b1)) : size == 2u ? getHex8(b1) : QString(""));
+        case 3: return QVariant(getHex8(processor->getMemoryByte(address)));
+        case 4: return QVariant(size >= 2u ? getHex8(b1) : QString(""));
+        case 5: return QVariant(size == 3u ? getHex8(b2) : QString(""));
+        default: return QVariant();
+        }
+    case Qt::FontRole: return QVariant(QFont("Monospace"));
+    case Qt::TextAlignmentRole: return QVariant(Qt::AlignCenter);
+    case Qt::BackgroundRole:
+        if(index.row() == rowOf(processor->getProgramCounter())) {
+            QBrush brush; brush.setStyle(Qt::Dense3Pattern); brush.setColor(pc);
+            return QVariant(brush);
+        }
+        return QVariant();
+    default: return QVariant(); //use default for rest
+    }
+}
+int DisassemblyModel::rowCount(const QModelIndex &parent) const {return parent.isValid() ? 0 : firstRow[PAGE_COUNT];} //override
+int DisassemblyModel::columnCount(const QModelIndex &parent) const {return parent.isValid() ? 0 : 6;} //override
+QVariant DisassemblyModel::headerData(int section, Qt::Orientation orientation, int role) const {//override
+    switch(orientation) {
+    case Qt::Horizontal: return columnHeader(section, role);
+    default: return QAbstractTableModel::headerData(section, orientation, role);
+    }
+}
+//private slots
+void DisassemblyModel::memoryBlockUpdated(memaddr_t startLoc, memsize_t blockSize) {
+    if(blockSize == 0u) return;
+    if(blockSize >= MEMORY_SIZE) {
+        //All of memory (a reset): decode everything afresh.
+        beginResetModel();
+        for(unsigned page = 0; page < PAGE_COUNT; page++) pages[page] = decode(page, page == 0u ? 0u : pages[page-1u].spill);
+        countRows();
+        endResetModel();
+        return;
+    }
+    //Bytes at the start of a page may be operands of the last instruction of the page before, which then shows them.
+    unsigned first = startLoc / PAGE_SIZE;
+    if(first > 0u && startLoc % PAGE_SIZE < pages[first-1u].spill) first--;
+    const memsize_t end = startLoc + blockSize - 1u;
+    if(end < MEMORY_SIZE) update(first, (unsigned)(end / PAGE_SIZE));
+    else {update(first, PAGE_COUNT - 1u); update(0u, (unsigned)((end - MEMORY_SIZE) / PAGE_SIZE));} //wrapped around
+}
+void DisassemblyModel::pcChanged() {
+    QVector<int> roles(1, Qt::BackgroundRole);
+    if(oldPC != processor->getProgramCounter()) {
+        const int oldRow = rowOf(oldPC);
+        oldPC = processor->getProgramCounter();
+        const int row = rowOf(oldPC);
+        emit dataChanged(createIndex(oldRow, 0), createIndex(oldRow, 5), roles);
+        emit dataChanged(createIndex(row, 0), createIndex(row, 5), roles);
+    }
+}
@@ -0,0 +1,105 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef DISASSEMBLYMODEL_H
+#define DISASSEMBLYMODEL_H
+
+#include <QAbstractTableModel>
+#include <QObject>
+#include <QModelIndex>
+#include <Qt>
+#include <QVariant>
+#include <QColor>
+#include <vector>
+#include "commdefs.h"
+#include "processor.h"
+#include "opcodes.h"
+
+///Table model showing all of processor memory disassembled, one row per instruction (or per byte which is not an opcode), so
+///that code written by a program (or edited in the memory table) can be followed as it changes.
+///
+///Memory is decoded by linear sweep in pages of 256 bytes. Only the row boundaries of each page are cached; the bytes are read
+///from memory when shown. When memory changes, only the pages it touched are decoded again (and the pages after them, as long
+///as an instruction at the end of a page reaches into the next one differently than before). An instruction never wraps around
+///from FFFFH to 0000H.
+class DisassemblyModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    ///Constructor
+    explicit DisassemblyModel(Processor *proc, QObject *parent = nullptr);
+    ///Data for each cell in table.
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const; //override
+    ///Number of rows = number of instructions and data bytes in memory.
+    int rowCount(const QModelIndex &parent = QModelIndex()) const; //override
+    ///Number of columns = 6.
+    int columnCount(const QModelIndex &parent = QModelIndex()) const; //override
+    ///Data for row and column headers.
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const; //override
+    ///Row of the instruction (or data byte) which holds address.
+    int rowOf(memaddr_t address) const;
+    ///Address of the first byte of a row.
+    memaddr_t addressOf(int row) const;
+private slots:
+    ///Processor memory updated outside of this class.
+    void memoryBlockUpdated(memaddr_t startLoc, memsize_t blockSize);
+    ///Processor program counter (PC) updated outside of this class.
+    void pcChanged();
+private:
+    ///Bytes per page.
+    static const memsize_t PAGE_SIZE = 256u;
+    ///Pages in memory.
+    static const unsigned PAGE_COUNT = (unsigned)(MEMORY_SIZE / PAGE_SIZE);
+    ///Decoded page.
+    struct Page {
+        ///Offsets (from the start of the page) of its rows. The first row may start after offset 0, if the last instruction of the
+        ///page before takes up the first bytes of this one.
+        std::vector<data8_t> rows;
+        ///Bytes of the next page taken up by the last instruction of this page (0 to 2).
+        data8_t spill;
+    };
+    ///Opcode of the instruction at address, or nullptr if the byte there is not one (or the instruction would wrap around).
+    const opcode *opcodeAt(memaddr_t address) const;
+    ///Decode page number page, whose first start bytes belong to the page before.
+    Page decode(unsigned page, data8_t start) const;
+    ///Replace a page by its decoded form, updating firstRow and telling views: rows are changed in place if the row boundaries
+    ///stay the same, and removed and inserted otherwise.
+    void replace(unsigned page, Page &decoded);
+    ///Decode pages from first to last again (and the pages after them whose start changes).
+    void update(unsigned first, unsigned last);
+    ///Compute firstRow from the row counts of the pages.
+    void countRows();
+    ///Get column header data.
+    static QVariant columnHeader(int column, int role);
+
+    ///Processor object of which memory is disassembled.
+    Processor *processor;
+    ///Decoded pages.
+    std::vector<Page> pages;
+    ///Row of the first row of each page; firstRow[PAGE_COUNT] is the number of rows.
+    std::vector<int> firstRow;
+    ///Old value of program counter (PC) before a call to pcChanged().
+    memaddr_t oldPC;
+    ///Highlighting background colour for the row of the instruction pointed to by program counter (PC).
+    static const QColor pc;
+};
+
+#endif // DISASSEMBLYMODEL_H
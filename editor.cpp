@@ -70,20 +70,28 @@ void Editor::highlightCurrentLine() {
         selection.cursor.clearSelection();
         extraSelections.append(selection);
     }
+    QColor redColor = QColor(palette().window().color().red(), 0, 0, 125).lighter();
+    for(int line : errorLines) {
+        QTextBlock block = document()->findBlockByLineNumber(line-1);
+        if(!block.isValid()) continue;
+        QTextEdit::ExtraSelection selection;
+        selection.format.setBackground(redColor);
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.cursor = textCursor();
+        selection.cursor.setPosition(block.position());
+        selection.cursor.clearSelection();
+        extraSelections.append(selection);
+    }
     setExtraSelections(extraSelections);
 }
 void Editor::setErrorLine(int value) {
-    QList<QTextEdit::ExtraSelection> extraSelections;
-    if(value < 1) highlightCurrentLine(); //just call normal
-    QTextEdit::ExtraSelection selection;
-    QColor redColor = QColor(palette().window().color().red(), 0, 0, 125).lighter();
-    selection.format.setBackground(redColor);
-    selection.format.setProperty(QTextFormat::FullWidthSelection, true);
-    selection.cursor = textCursor();
-    selection.cursor.setPosition(document()->findBlockByLineNumber(value-1).position());
-    selection.cursor.clearSelection();
-    extraSelections.append(selection);
-    setExtraSelections(extraSelections);
+    QList<int> lines;
+    if(value >= 1) lines.append(value);
+    setErrorLines(lines);
+}
+void Editor::setErrorLines(const QList<int> &lines) {
+    errorLines = lines;
+    highlightCurrentLine();
 }
 void Editor::lineNumberAreaPaintEvent(QPaintEvent *event) {
     QPainter painter(lineNumberArea);
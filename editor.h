@@ -29,6 +29,7 @@ furnished to do so, subject to the following conditions:
 #include <QResizeEvent>
 #include <QRect>
 #include <QSize>
+#include <QList>
 
 //For clues, the following code and editor.cpp was adapted from:
 //https://doc.qt.io/qt-5/qtwidgets-widgets-codeeditor-example.html
@@ -57,11 +58,16 @@ private slots:
     ///Update line number area on edit.
     void updateLineNumberArea(const QRect &rect, int dy);
 public slots:
-    ///Called when the system detects an error in the given line number.
+    ///Called when the system detects an error in the given line number (a value less than 1 clears the error lines).
     void setErrorLine(int);
+    ///Called with every line number (starting from 1) currently known to contain an error; replaces the previous list. The
+    ///lines stay marked while the cursor moves, until the next call.
+    void setErrorLines(const QList<int> &);
 private:
     ///The sub-component used to display line numbers.
     QWidget *lineNumberArea;
+    ///Lines currently marked as erroneous.
+    QList<int> errorLines;
 };
 
 ///The component (sub-component of Editor) used to display line numbers.
@@ -0,0 +1,95 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "expression.h"
+
+///Evaluation of both kinds of expressions; lookup is called as lookup(name, value, base).
+template<class Lookup>
+static ExprStatus evaluate(const ExprItem *e, data16_t here, const ExprBase &hereBase, const Lookup &lookup, data16_t &value,
+                           ExprBase &base, string_id_t &undefined) {
+    data16_calc_t stack[EXPR_STACK_SIZE]; ExprBase bases[EXPR_STACK_SIZE]; size_t top = 0;
+    for(; e->op != ExprItem::END; e++) {
+        switch(e->op) {
+        case ExprItem::NUMBER: bases[top] = ExprBase(); stack[top++] = e->value & 0xFFFFu; continue;
+        case ExprItem::SYMBOL: {
+            data16_t x; bases[top] = ExprBase();
+            if(!lookup(e->value, x, bases[top])) {undefined = e->value; return EXPR_UNDEFINED;}
+            stack[top++] = x; continue;
+        }
+        case ExprItem::HERE: bases[top] = hereBase; stack[top++] = here; continue;
+        case ExprItem::NEG: case ExprItem::HIGH: case ExprItem::LOW: case ExprItem::NOT:
+            if(!bases[top-1].isAbsolute()) {
+                //HIGH and LOW of a relative value pick a byte of the final value; the offset stays whole until then.
+                if(bases[top-1].part != ExprItem::END || (e->op != ExprItem::HIGH && e->op != ExprItem::LOW)) return EXPR_NOT_RELOCATABLE;
+                bases[top-1].part = e->op; continue;
+            }
+            switch(e->op) {
+            case ExprItem::NEG: stack[top-1] = NEGATE16(stack[top-1]); break;
+            case ExprItem::HIGH: stack[top-1] = (stack[top-1] >> 8) & 0xFFu; break;
+            case ExprItem::LOW: stack[top-1] &= 0xFFu; break;
+            default: stack[top-1] = ~stack[top-1] & 0xFFFFu; break;
+            }
+            continue;
+        default: break;
+        }
+        const data16_calc_t b = stack[--top], a = stack[top-1];
+        data16_calc_t &r = stack[top-1];
+        if(!bases[top].isAbsolute() || !bases[top-1].isAbsolute()) {
+            //Only X+n, n+X, X-n and X-Y (same base) can be fixed up by the linker.
+            const ExprBase &x = bases[top-1], &y = bases[top];
+            if(x.part != ExprItem::END || y.part != ExprItem::END) return EXPR_NOT_RELOCATABLE;
+            const bool plus = e->op == ExprItem::ADD && (x.isAbsolute() || y.isAbsolute());
+            const bool minus = e->op == ExprItem::SUB && (y.isAbsolute() || x.sameAs(y));
+            if(!plus && !minus) return EXPR_NOT_RELOCATABLE;
+            bases[top-1] = minus && !y.isAbsolute() ? ExprBase() : x.isAbsolute() ? y : x;
+        }
+        switch(e->op) {
+        case ExprItem::ADD: r = a + b; break;
+        case ExprItem::SUB: r = a + NEGATE16(b); break;
+        case ExprItem::MUL: r = a * b; break;
+        case ExprItem::DIV: if(b == 0u) return EXPR_DIVISION_BY_ZERO; r = a / b; break;
+        case ExprItem::MOD: if(b == 0u) return EXPR_DIVISION_BY_ZERO; r = a % b; break;
+        case ExprItem::AND: r = a & b; break;
+        case ExprItem::OR: r = a | b; break;
+        case ExprItem::SHL: r = b >= 16u ? 0u : a << b; break;
+        case ExprItem::SHR: r = b >= 16u ? 0u : a >> b; break;
+        case ExprItem::EQ: r = a == b ? 0xFFFFu : 0u; break;
+        case ExprItem::NE: r = a != b ? 0xFFFFu : 0u; break;
+        case ExprItem::LT: r = a < b ? 0xFFFFu : 0u; break;
+        case ExprItem::GT: r = a > b ? 0xFFFFu : 0u; break;
+        case ExprItem::LE: r = a <= b ? 0xFFFFu : 0u; break;
+        case ExprItem::GE: r = a >= b ? 0xFFFFu : 0u; break;
+        default: break;
+        }
+        r &= 0xFFFFu;
+    }
+    value = (data16_t)stack[0]; base = bases[0];
+    return EXPR_OK;
+}
+ExprStatus evaluateExpression(const ExprItem *e, data16_t here, const SymbolLookup &lookup, data16_t &value,
+                              string_id_t &undefined) {
+    ExprBase base;
+    return evaluate(e, here, ExprBase(), [&](string_id_t name, data16_t &x, ExprBase &) {return lookup(name, x);}, value, base, undefined);
+}
+ExprStatus evaluateRelocatable(const ExprItem *e, data16_t here, const ExprBase &hereBase, const RelocatableLookup &lookup,
+                               data16_t &value, ExprBase &base, string_id_t &undefined) {
+    return evaluate(e, here, hereBase, lookup, value, base, undefined);
+}
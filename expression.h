@@ -0,0 +1,126 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstdint>
+#include <functional>
+#include "commdefs.h"
+#include "stringpool.h"
+
+///One item of an operand expression in postfix (reverse Polish) form. Expressions are parsed once per source line, but can
+///only be evaluated during assembly, when the values of the symbols (and of $) are known.
+struct ExprItem {
+    ///Operations
+    enum Op : uint_least8_t {
+        ///End of the expression
+        END = 0,
+        ///Push the number in value
+        NUMBER,
+        ///Push the value of the symbol named by value (a string_id_t)
+        SYMBOL,
+        ///Push the current address ($)
+        HERE,
+        ///Unary minus
+        NEG,
+        ///Most significant byte
+        HIGH,
+        ///Least significant byte
+        LOW,
+        ///Bitwise complement
+        NOT,
+        ///Binary operators; pop two values and push the result
+        ADD, SUB, MUL, DIV, MOD, AND, OR, SHL, SHR,
+        ///Comparisons (unsigned); the result is 0FFFFH if true and 0 if false
+        EQ, NE, LT, GT, LE, GE,
+        ///Not evaluated: in the deferred items of a DB or DW line, marks the offset (value) in the data at which the value of
+        ///the expression following it goes
+        AT
+    } op;
+    ///Operand of NUMBER and SYMBOL
+    uint_least32_t value;
+};
+
+///Maximum depth of the evaluation stack; the parser rejects expressions which would need more.
+#define EXPR_STACK_SIZE 32u
+
+///Outcome of evaluateExpression
+enum ExprStatus : int {
+    ///Evaluated successfully
+    EXPR_OK = 0,
+    ///A symbol is not defined (yet)
+    EXPR_UNDEFINED,
+    ///Division or MOD by zero
+    EXPR_DIVISION_BY_ZERO,
+    ///The value depends on where a module is placed (or on a symbol of another module) in a way the linker cannot fix up
+    EXPR_NOT_RELOCATABLE
+};
+
+///What a value is relative to, if it is not a plain number: the start of a relocatable module, or a symbol imported from another
+///module. Such values are only known once modules are linked (see linker.h); until then they are kept as offsets from the base.
+struct ExprBase {
+    ///Kinds of bases
+    enum Kind : uint_least8_t {
+        ///None; the value is a plain number
+        ABSOLUTE = 0,
+        ///Start of the module being assembled
+        MODULE,
+        ///Imported symbol, named by symbol
+        IMPORT
+    } kind;
+    ///Part of the final value which is used: END for all of it, HIGH or LOW for one of its bytes
+    ExprItem::Op part;
+    ///Name of the imported symbol (IMPORT only)
+    string_id_t symbol;
+
+    ///Constructor (a plain number)
+    ExprBase() : kind(ABSOLUTE), part(ExprItem::END), symbol(0u) {}
+    ///Constructor
+    ExprBase(Kind kind, string_id_t symbol = 0u) : kind(kind), part(ExprItem::END), symbol(symbol) {}
+    ///Is the value a plain number?
+    bool isAbsolute() const {return kind == ABSOLUTE;}
+    ///Same base (ignoring part)?
+    bool sameAs(const ExprBase &o) const {return kind == o.kind && symbol == o.symbol;}
+};
+
+///Looks up the value of a symbol by name; returns false if it is not defined.
+typedef std::function<bool(string_id_t, data16_t &)> SymbolLookup;
+
+///Evaluate an expression (terminated by an END item) with 16-bit arithmetic, like the 8085 itself: results wrap around and
+///negative numbers are in 2's complement. here is the value of $. If a symbol is undefined, its name is stored in undefined.
+ExprStatus evaluateExpression(const ExprItem *expression, data16_t here, const SymbolLookup &lookup, data16_t &value,
+                              string_id_t &undefined);
+
+///Looks up the value of a symbol by name, and what it is relative to; returns false if it is not defined.
+typedef std::function<bool(string_id_t, data16_t &, ExprBase &)> RelocatableLookup;
+
+///Evaluate an expression whose symbols (and $, relative to hereBase) may be relative to a base, as evaluateExpression does. The
+///result is relative to base: it may be a plain number, or X+n, X-n or HIGH/LOW of those (X being a base), where value is
+///the offset n (not split into a byte); the difference of two values with the same base is a plain number. Anything else
+///gives EXPR_NOT_RELOCATABLE.
+ExprStatus evaluateRelocatable(const ExprItem *expression, data16_t here, const ExprBase &hereBase, const RelocatableLookup &lookup,
+                               data16_t &value, ExprBase &base, string_id_t &undefined);
+
+///Is the 16-bit value usable as a byte operand (0 to 255, or -128 to -1 in 2's complement)?
+inline bool fitsInByte(data16_t value) {return value <= 0xFFu || value >= 0xFF80u;}
+
+#endif // EXPRESSION_H
@@ -0,0 +1,110 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef IODEVICE_H
+#define IODEVICE_H
+
+#include "commdefs.h"
+
+///A peripheral attached to the processor's I/O bus (or, later, to a region of its memory space). Devices are called directly
+///from the processor's execution thread during the IN/OUT (or memory access) machine cycle, so implementations may have side
+///effects on read, must not block and must not touch GUI objects. Registers are addressed by their offset from the first
+///address the device was attached at.
+class IODevice {
+public:
+    virtual ~IODevice() = default;
+    ///Read register reg of this device. now is the processor cycle count (T-states since RESET_IN) at the time of access.
+    virtual data8_t read(memaddr_t reg, cycles_t now) = 0;
+    ///Write data into register reg of this device. now is the processor cycle count (T-states since RESET_IN) at the time of access.
+    virtual void write(memaddr_t reg, data8_t data, cycles_t now) = 0;
+    ///Bring this device to its power-on state. Called by the processor on RESET_IN (the cycle count restarts from 0).
+    virtual void reset() {}
+};
+
+///A peripheral wired to the processor's serial pins (SOD and SID). The processor calls it from its execution thread when SIM
+///changes SOD and when RIM samples SID, so a device can encode and decode a bit-banged serial line lazily, from the cycle
+///count of those accesses alone.
+class SerialLineDevice {
+public:
+    virtual ~SerialLineDevice() = default;
+    ///SIM has set the SOD latch to level at processor cycle count now.
+    virtual void serialOutputChanged(bool level, cycles_t now) = 0;
+    ///RIM samples SID at processor cycle count now; return the level of the line.
+    virtual bool serialInputLevel(cycles_t now) = 0;
+    ///Bring this device to its power-on state. Called by the processor on RESET_IN (the cycle count restarts from 0).
+    virtual void reset() {}
+};
+
+///Processor interrupt inputs a device output can be wired to.
+enum InterruptLine : int {
+    ///Not connected
+    NO_INTERRUPT = 0,
+    ///TRAP (edge and level sensitive, non-maskable)
+    TRAP_LINE,
+    ///RST 7.5 (rising edge sensitive)
+    RST7_5_LINE,
+    ///RST 6.5 (level sensitive)
+    RST6_5_LINE,
+    ///RST 5.5 (level sensitive)
+    RST5_5_LINE,
+    ///INTR (level sensitive)
+    INTR_LINE
+};
+
+///One entry of the processor's I/O port table.
+struct IOPortMapping {
+    ///Device handling this port; nullptr if the port is a plain latch.
+    IODevice *device;
+    ///First port of the range the device was attached at (so that port - first is the register offset).
+    ioaddr_t first;
+};
+
+///Kinds of page in the processor's memory map.
+enum MemoryPageType : data8_t {
+    ///Read/write memory
+    RAM_PAGE = 0,
+    ///Read-only memory; program writes are ignored (or trapped)
+    ROM_PAGE,
+    ///Nothing there; reads return 0xFF and writes are ignored
+    UNMAPPED_PAGE,
+    ///Memory-mapped device registers
+    DEVICE_PAGE
+};
+
+///Number of address bits within a memory map page (pages are 256 bytes).
+#define MEMORY_PAGE_BITS    8
+///Number of pages in the memory map.
+#define MEMORY_PAGE_COUNT   (MEMORY_SIZE >> MEMORY_PAGE_BITS)
+
+///One entry of the processor's memory map.
+struct MemoryPage {
+    ///What the page is.
+    MemoryPageType type;
+    ///Device handling the page (DEVICE_PAGE only).
+    IODevice *device;
+    ///First address of the region the device was mapped at (so that address - first is the register offset).
+    memaddr_t first;
+    ///Length of that region. Accesses to the page outside it (an unaligned region shares its first and last pages) are
+    ///unmapped.
+    memsize_t length;
+};
+
+#endif // IODEVICE_H
@@ -0,0 +1,147 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "keyboard8279.h"
+
+Keyboard8279::Keyboard8279(Processor *processor, int refreshInterval, QObject *parent)
+    : QObject(parent), processor(processor), irqLine(NO_INTERRUPT), irqLevel(false), displayDirty(false),
+      refreshTimer(new QTimer(this)) {
+    reset();
+    connect(refreshTimer, &QTimer::timeout, this, &Keyboard8279::refresh);
+    refreshTimer->start(refreshInterval);
+}
+
+void Keyboard8279::writeDisplay(data8_t data) {
+    data8_t keep = ((inhibitBlank & 0x08u) ? 0xF0u : 0x00u) | ((inhibitBlank & 0x04u) ? 0x0Fu : 0x00u);
+    if(displayMode & 2u) { //right entry: characters enter at the right and shift the display left
+        unsigned length = displayLength();
+        for(unsigned i = 1; i < length; i++) display[i - 1u] = display[i];
+        display[length - 1u] = (display[length - 1u] & keep) | (data & ~keep & 0xFFu);
+    }
+    else {
+        display[displayAddress] = (display[displayAddress] & keep) | (data & ~keep & 0xFFu);
+        if(displayAutoIncrement) displayAddress = (displayAddress + 1u) % DISPLAY_SIZE;
+    }
+    displayDirty = true;
+}
+void Keyboard8279::updateInterrupt() {
+    bool level = sensorMode() ? false : !fifo.empty();
+    if(irqLine != NO_INTERRUPT && level != irqLevel) processor->setInterruptLine(irqLine, level);
+    irqLevel = level;
+}
+
+data8_t Keyboard8279::read(memaddr_t reg, cycles_t) {
+    if(reg & 1u) { //status
+        return (overrun ? 0x20u : 0u) | (underrun ? 0x10u : 0u) | (fifo.size() >= FIFO_SIZE ? 0x08u : 0u) |
+                (fifo.size() & 7u);
+    }
+    if(readingDisplay) {
+        data8_t data = display[displayAddress];
+        if(displayAutoIncrement) displayAddress = (displayAddress + 1u) % DISPLAY_SIZE;
+        return data;
+    }
+    if(sensorMode()) {
+        data8_t data = sensors[sensorAddress];
+        if(sensorAutoIncrement) sensorAddress = (sensorAddress + 1u) % FIFO_SIZE;
+        return data;
+    }
+    if(fifo.empty()) {underrun = true; return 0u;}
+    data8_t data = fifo.front();
+    fifo.pop_front();
+    updateInterrupt();
+    return data;
+}
+void Keyboard8279::write(memaddr_t reg, data8_t data, cycles_t) {
+    if(!(reg & 1u)) {writeDisplay(data); return;}
+    switch((data >> 5) & 7u) {
+    case 0u: //keyboard/display mode set
+        displayMode = (data >> 3) & 3u; keyboardMode = data & 7u;
+        displayDirty = true; updateInterrupt();
+        break;
+    case 1u: break; //program clock; the scan rate is not modelled
+    case 2u: //read FIFO/sensor RAM
+        readingDisplay = false; sensorAutoIncrement = data & 0x10u; sensorAddress = data & 7u;
+        break;
+    case 3u: //read display RAM
+        readingDisplay = true; displayAutoIncrement = data & 0x10u; displayAddress = data & 0xFu;
+        break;
+    case 4u: //write display RAM; reads still come from wherever the last read command pointed
+        displayAutoIncrement = data & 0x10u; displayAddress = data & 0xFu;
+        break;
+    case 5u: //display write inhibit/blanking
+        inhibitBlank = data & 0xFu; displayDirty = true;
+        break;
+    case 6u: //clear
+        if(data & 0x10u) blankCode = (data & 0x08u) ? ((data & 0x04u) ? 0xFFu : 0x20u) : 0x00u; //CD: zeros, 20H or ones
+        if(data & 0x11u) { //clear display (CD2 or clear all)
+            for(unsigned i = 0; i < DISPLAY_SIZE; i++) display[i] = blankCode;
+            displayAddress = 0u; displayDirty = true;
+        }
+        if(data & 0x03u) { //clear FIFO status (CF) or all (CA)
+            fifo.clear(); overrun = underrun = false;
+            updateInterrupt();
+        }
+        break;
+    default: //end interrupt/error mode set
+        updateInterrupt();
+    }
+}
+void Keyboard8279::reset() {
+    for(unsigned i = 0; i < DISPLAY_SIZE; i++) display[i] = 0u;
+    for(unsigned i = 0; i < FIFO_SIZE; i++) sensors[i] = 0u;
+    fifo.clear();
+    displayMode = 1u; keyboardMode = 0u; //16 character left entry, encoded scan keyboard with 2-key lockout
+    displayAddress = sensorAddress = 0u;
+    displayAutoIncrement = sensorAutoIncrement = readingDisplay = false;
+    inhibitBlank = 0u; blankCode = 0u; overrun = underrun = false;
+    displayDirty = true;
+    updateInterrupt();
+}
+
+void Keyboard8279::connectInterrupt(InterruptLine line) {
+    if(irqLine != NO_INTERRUPT && irqLevel) processor->setInterruptLine(irqLine, false); //release the old line
+    irqLine = line; irqLevel = false;
+    updateInterrupt();
+}
+void Keyboard8279::pressKey(data8_t code) {
+    if(sensorMode()) return;
+    if(fifo.size() >= FIFO_SIZE) {overrun = true; return;}
+    fifo.push_back(code);
+    updateInterrupt();
+}
+void Keyboard8279::scheduleKeyPress(cycles_t when, data8_t code) {
+    processor->scheduleEvent(when, [this, code](){pressKey(code);});
+}
+void Keyboard8279::setSensorRow(unsigned row, data8_t value) {
+    if(row < FIFO_SIZE) sensors[row] = value;
+}
+QByteArray Keyboard8279::getDisplay() const {
+    unsigned length = displayLength();
+    QByteArray characters((int)length, '\0');
+    data8_t blanked = ((inhibitBlank & 0x02u) ? 0xF0u : 0x00u) | ((inhibitBlank & 0x01u) ? 0x0Fu : 0x00u);
+    for(unsigned i = 0; i < length; i++) characters[i] = (char)((display[i] & ~blanked) | (blankCode & blanked));
+    return characters;
+}
+void Keyboard8279::refresh() {
+    if(!displayDirty) return;
+    displayDirty = false;
+    emit displayUpdated(getDisplay());
+}
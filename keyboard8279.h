@@ -0,0 +1,126 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef KEYBOARD8279_H
+#define KEYBOARD8279_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QTimer>
+#include <deque>
+#include "processor.h"
+
+///Models an 8279 keyboard/display controller (data register at register offset 0, command/status register at offset 1): the
+///16 byte display RAM (left or right entry, auto-increment, write inhibit and blanking), the 8 character key FIFO (or the 8
+///row sensor RAM in sensor matrix mode), the clear and end interrupt commands, and the IRQ output, which can be wired to an
+///interrupt line.
+///
+///Display writes only update the display RAM. A timer running at the display refresh rate emits displayUpdated() at most once
+///per refresh period, and only if the display changed, so a monitor program rewriting its digits in a loop costs nothing on
+///the GUI side. Key presses can be injected immediately or scheduled at a processor cycle count.
+///
+///The device lives on the thread the processor runs on; pressKey() and the other external inputs must be called from it.
+class Keyboard8279 : public QObject, public IODevice
+{
+    Q_OBJECT
+public:
+    ///Size of the display RAM.
+    static const unsigned DISPLAY_SIZE = 16u;
+    ///Depth of the key FIFO (and size of the sensor RAM).
+    static const unsigned FIFO_SIZE = 8u;
+private:
+    ///Processor this controller is connected to.
+    Processor * const processor;
+    ///Display RAM.
+    data8_t display[DISPLAY_SIZE];
+    ///Sensor RAM (sensor matrix mode).
+    data8_t sensors[FIFO_SIZE];
+    ///Key FIFO (keyboard modes).
+    std::deque<data8_t> fifo;
+    ///Display mode (DD bits of the mode set command): 0/1 left entry, 2/3 right entry; 8 characters if even, 16 if odd.
+    unsigned displayMode;
+    ///Keyboard mode (KKK bits of the mode set command); 4 and 5 are sensor matrix modes, 6 and 7 strobed input.
+    unsigned keyboardMode;
+    ///Display RAM address for the next data read/write.
+    unsigned displayAddress;
+    ///Sensor RAM address for the next data read.
+    unsigned sensorAddress;
+    ///Auto-increment display RAM address after each access.
+    bool displayAutoIncrement;
+    ///Auto-increment sensor RAM address after each read.
+    bool sensorAutoIncrement;
+    ///True if the last read command was read display RAM (else FIFO/sensor RAM).
+    bool readingDisplay;
+    ///Write inhibit and blanking bits (IW A, IW B, BL A, BL B in D3 to D0).
+    data8_t inhibitBlank;
+    ///Byte written into the display RAM by the clear commands and shown for blanked nibbles.
+    data8_t blankCode;
+    ///FIFO overrun error flag.
+    bool overrun;
+    ///FIFO underrun error flag.
+    bool underrun;
+    ///Interrupt line the IRQ output is wired to.
+    InterruptLine irqLine;
+    ///Level last driven onto irqLine.
+    bool irqLevel;
+    ///True if the display changed since the last displayUpdated().
+    bool displayDirty;
+    ///Fires at the display refresh rate.
+    QTimer *refreshTimer;
+
+    ///Number of characters in the display (8 or 16).
+    unsigned displayLength() const {return (displayMode & 1u) ? 16u : 8u;}
+    ///True in the sensor matrix modes.
+    bool sensorMode() const {return keyboardMode == 4u || keyboardMode == 5u;}
+    ///Write data into the display RAM (honouring the entry mode and write inhibit bits).
+    void writeDisplay(data8_t data);
+    ///Drive the IRQ line to the current state.
+    void updateInterrupt();
+public:
+    ///Constructor. The display is refreshed every refreshInterval milliseconds (50 Hz by default).
+    explicit Keyboard8279(Processor *processor, int refreshInterval = 20, QObject *parent = nullptr);
+
+    data8_t read(memaddr_t reg, cycles_t now); //override
+    void write(memaddr_t reg, data8_t data, cycles_t now); //override
+    void reset(); //override
+
+    ///Wire the IRQ output to interrupt line (NO_INTERRUPT to disconnect).
+    void connectInterrupt(InterruptLine line);
+    ///Push a key code (SHIFT in D7, CNTL in D6, scan row in D5-D3, return line in D2-D0) into the FIFO now.
+    void pressKey(data8_t code);
+    ///Push a key code into the FIFO once the processor cycle count reaches when (dropped by RESET_IN). The controller must
+    ///outlive the event.
+    void scheduleKeyPress(cycles_t when, data8_t code);
+    ///Set a row of the sensor RAM (sensor matrix mode).
+    void setSensorRow(unsigned row, data8_t value);
+    ///Get the displayed characters (the display RAM with blanking applied; 8 or 16 bytes as per the display mode).
+    QByteArray getDisplay() const;
+    ///Change the display refresh period (in milliseconds).
+    void setRefreshInterval(int milliseconds) {refreshTimer->setInterval(milliseconds);}
+public slots:
+    ///Emit displayUpdated() if the display changed since the last refresh.
+    void refresh();
+signals:
+    ///The displayed characters changed (see getDisplay()). Emitted at most once per refresh period.
+    void displayUpdated(const QByteArray &characters);
+};
+
+#endif // KEYBOARD8279_H
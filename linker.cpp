@@ -0,0 +1,184 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "linker.h"
+#include "processor.h"
+#include <unordered_map>
+#include <QFile>
+
+//ObjectModule
+
+///First bytes of an object file: a signature and the version of the format.
+static const char OBJECT_MAGIC[4] = {'O', '8', '5', '\1'};
+
+static void put8(std::string &out, unsigned x) {out.push_back((char)(x & 0xFFu));}
+static void put16(std::string &out, unsigned x) {put8(out, x); put8(out, x >> 8);}
+static void put32(std::string &out, uint_least32_t x) {put16(out, x & 0xFFFFu); put16(out, (x >> 16) & 0xFFFFu);}
+static void putString(std::string &out, const std::string &s) {put32(out, (uint_least32_t)s.length()); out.append(s);}
+
+///Reads the fields of an object file; every read fails (and keeps failing) once the data runs out.
+struct ObjectReader {
+    const unsigned char *data; size_t length, position; bool ok;
+    ObjectReader(const char *data, size_t length) : data((const unsigned char *)data), length(length), position(0u), ok(true) {}
+    bool has(size_t n) {if(ok && length - position < n) ok = false; return ok;}
+    unsigned get8() {return has(1u) ? data[position++] : 0u;}
+    unsigned get16() {const unsigned lo = get8(); return lo | (get8() << 8);}
+    uint_least32_t get32() {const uint_least32_t lo = get16(); return lo | ((uint_least32_t)get16() << 16);}
+    std::string getString() {
+        const size_t n = get32();
+        if(!has(n)) return std::string();
+        position += n; return std::string((const char *)data + position - n, n);
+    }
+    ///Count of items which take at least size bytes each (guards against absurd counts in damaged files).
+    size_t getCount(size_t size) {const size_t n = get32(); return has(n * size) ? n : 0u;}
+};
+
+void ObjectModule::clear() {
+    relocatable = true; size = 0u;
+    sections.clear(); relocations.clear(); exports.clear(); imports.clear();
+}
+std::string ObjectModule::serialize() const {
+    //All numbers are little-endian. Strings and lists are preceded by their 32-bit lengths.
+    std::string out(OBJECT_MAGIC, sizeof(OBJECT_MAGIC));
+    putString(out, name);
+    put8(out, relocatable); put32(out, (uint_least32_t)size);
+    put32(out, (uint_least32_t)sections.size());
+    for(const Section &section : sections) {
+        put16(out, section.address); put32(out, (uint_least32_t)section.bytes.size());
+        out.append(section.bytes.begin(), section.bytes.end());
+    }
+    put32(out, (uint_least32_t)imports.size());
+    for(const std::string &import : imports) putString(out, import);
+    put32(out, (uint_least32_t)exports.size());
+    for(const Export &e : exports) {putString(out, e.name); put16(out, e.value); put8(out, e.relocatable);}
+    put32(out, (uint_least32_t)relocations.size());
+    for(const Relocation &r : relocations) {
+        put16(out, r.address); put16(out, r.addend); put8(out, r.isByte); put8(out, r.part); put32(out, r.symbol);
+    }
+    return out;
+}
+bool ObjectModule::deserialize(const char *data, size_t length) {
+    clear(); name.clear();
+    ObjectReader in(data, length);
+    if(!in.has(sizeof(OBJECT_MAGIC)) || std::memcmp(data, OBJECT_MAGIC, sizeof(OBJECT_MAGIC)) != 0) return false;
+    in.position = sizeof(OBJECT_MAGIC);
+    name = in.getString();
+    relocatable = in.get8() != 0u; size = in.get32();
+    if(size > MEMORY_SIZE) in.ok = false;
+    sections.resize(in.getCount(6u));
+    for(Section &section : sections) {
+        section.address = in.get16();
+        const size_t n = in.get32();
+        if(n > MEMORY_SIZE || !in.has(n)) {in.ok = false; break;}
+        section.bytes.assign(in.data + in.position, in.data + in.position + n); in.position += n;
+    }
+    imports.resize(in.getCount(4u));
+    for(std::string &import : imports) import = in.getString();
+    exports.resize(in.getCount(7u));
+    for(Export &e : exports) {e.name = in.getString(); e.value = in.get16(); e.relocatable = in.get8() != 0u;}
+    relocations.resize(in.getCount(10u));
+    for(Relocation &r : relocations) {
+        r.address = in.get16(); r.addend = in.get16(); r.isByte = in.get8() != 0u;
+        const unsigned part = in.get8();
+        if(part != ExprItem::END && part != ExprItem::HIGH && part != ExprItem::LOW) in.ok = false;
+        r.part = (ExprItem::Op)part;
+        r.symbol = in.get32();
+        if(r.symbol != MODULE_BASE && r.symbol >= imports.size()) in.ok = false;
+    }
+    if(!in.ok || in.position != length) {clear(); name.clear(); return false;}
+    return true;
+}
+bool ObjectModule::save(const QString &path) const {
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    const std::string data = serialize();
+    return file.write(data.data(), (qint64)data.length()) == (qint64)data.length();
+}
+bool ObjectModule::load(const QString &path) {
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {clear(); name.clear(); return false;}
+    const QByteArray data = file.readAll();
+    return deserialize(data.constData(), (size_t)data.size());
+}
+
+//Linker
+
+Linker::Linker() : image(MEMORY_SIZE, 0u), owner(MEMORY_SIZE, 0u) {}
+
+///Name of a module for messages.
+static std::string moduleName(const std::vector<const ObjectModule *> &modules, size_t k) {
+    return modules[k]->name.empty() ? "module " + unsignedNumber(k + 1u) : modules[k]->name;
+}
+void Linker::link(const std::vector<const ObjectModule *> &modules, memaddr_t base) {
+    std::fill(image.begin(), image.end(), (data8_t)0u);
+    std::fill(owner.begin(), owner.end(), 0u);
+    bases.assign(modules.size(), 0u); blocks.clear();
+    //Exports of all modules by name. A name exported by two modules is only an error if some module imports it.
+    struct Definition {size_t module, other; const ObjectModule::Export *symbol;};
+    std::unordered_map<std::string, Definition> definitions;
+    for(size_t k = 0; k < modules.size(); k++) for(const ObjectModule::Export &e : modules[k]->exports) {
+        const std::pair<std::unordered_map<std::string, Definition>::iterator, bool> it = definitions.insert({e.name, Definition{k, k, &e}});
+        if(!it.second) it.first->second.other = k;
+    }
+    //Relocatable modules go one after the other.
+    memsize_t next = base;
+    for(size_t k = 0; k < modules.size(); k++) if(modules[k]->relocatable) {
+        if(next + modules[k]->size > MEMORY_SIZE) throw LinkError(moduleName(modules, k) + " does not fit in memory");
+        bases[k] = (memaddr_t)next; next += modules[k]->size;
+    }
+    for(size_t k = 0; k < modules.size(); k++) {
+        for(const ObjectModule::Section &section : modules[k]->sections) for(size_t j = 0; j < section.bytes.size(); j++) {
+            const memaddr_t address = (bases[k] + section.address + j) & 0xFFFFu;
+            if(owner[address] != 0u) throw LinkError(moduleName(modules, k) + " overlaps " + moduleName(modules, owner[address] - 1u) +
+                                                     " at address " + unsignedNumber(address, 16u) + "H");
+            owner[address] = (unsigned)k + 1u; image[address] = section.bytes[j];
+        }
+    }
+    for(size_t k = 0; k < modules.size(); k++) for(const ObjectModule::Relocation &r : modules[k]->relocations) {
+        data16_calc_t value = bases[k];
+        if(r.symbol != ObjectModule::MODULE_BASE) {
+            const std::string &name = modules[k]->imports[r.symbol];
+            const std::unordered_map<std::string, Definition>::const_iterator it = definitions.find(name);
+            if(it == definitions.end()) throw LinkError("Undefined symbol " + name + " (used by " + moduleName(modules, k) + ")");
+            const Definition &d = it->second;
+            if(d.other != d.module) throw LinkError("Symbol " + name + " is defined by both " + moduleName(modules, d.module) +
+                                                    " and " + moduleName(modules, d.other));
+            value = d.symbol->value + (d.symbol->relocatable ? bases[d.module] : 0u);
+        }
+        value = (value + r.addend) & 0xFFFFu;
+        if(r.part == ExprItem::HIGH) value >>= 8;
+        else if(r.part == ExprItem::LOW) value &= 0xFFu;
+        else if(r.isByte && !fitsInByte((data16_t)value))
+            throw LinkError("Value " + unsignedNumber(value, 16u) + "H does not fit in a byte (in " + moduleName(modules, k) + ")");
+        const memaddr_t address = (bases[k] + r.address) & 0xFFFFu;
+        image[address] = (data8_t)(value & 0xFFu);
+        if(!r.isByte) image[(address + 1u) & 0xFFFFu] = (data8_t)((value >> 8) & 0xFFu);
+    }
+    for(memsize_t first = 0u; first < MEMORY_SIZE;) {
+        if(owner[first] == 0u) {first++; continue;}
+        memsize_t last = first;
+        while(last < MEMORY_SIZE && owner[last] != 0u) last++;
+        blocks.push_back({first, last}); first = last;
+    }
+}
+void Linker::load(Processor &processor) const {
+    for(const std::pair<memsize_t, memsize_t> &block : blocks) processor.overwrite(image.data() + block.first, block.first, block.second - block.first);
+}
@@ -0,0 +1,137 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef LINKER_H
+#define LINKER_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <QException>
+#include <QString>
+#include "commdefs.h"
+#include "expression.h"
+
+class Processor;
+
+///Result of assembling one source file on its own (see Assembler::runAssembly()): its bytes, the places which the linker has
+///to fix up, and its symbols. A module is relocatable (placed by the linker; its addresses are offsets from its start) unless it
+///uses ORG or DATA, in which case everything in it is at fixed addresses. Object modules can be saved and loaded, so modules
+///which did not change need not be assembled again.
+struct ObjectModule {
+    ///A block of consecutive bytes.
+    struct Section {
+        ///Address of the first byte (an offset from the start of the module, if it is relocatable)
+        memaddr_t address;
+        std::vector<data8_t> bytes;
+    };
+    ///A value in the bytes of the module which depends on where the module is placed, or on a symbol of another module.
+    struct Relocation {
+        ///Where the value goes (an offset, if the module is relocatable)
+        memaddr_t address;
+        ///Offset of the value from its base
+        data16_t addend;
+        ///One byte or two (low byte first)?
+        bool isByte;
+        ///Part of the value which is written: END for all of it, HIGH or LOW for one of its bytes
+        ExprItem::Op part;
+        ///Base of the value: the index of an imported symbol in imports, or MODULE_BASE for the start of the module
+        uint_least32_t symbol;
+    };
+    ///Base of relocations relative to the start of the module
+    static const uint_least32_t MODULE_BASE = 0xFFFFFFFFu;
+    ///A symbol which other modules may use.
+    struct Export {
+        ///Name (upper case)
+        std::string name;
+        data16_t value;
+        ///Is the value an offset from the start of the module?
+        bool relocatable;
+    };
+
+    ///Name of the module, for messages (usually the name of its source file)
+    std::string name;
+    ///Is the module relocatable?
+    bool relocatable;
+    ///Address space taken up by a relocatable module (including blocks reserved by DS)
+    memsize_t size;
+    std::vector<Section> sections;
+    std::vector<Relocation> relocations;
+    std::vector<Export> exports;
+    ///Names (upper case) of the symbols used but not defined by the module
+    std::vector<std::string> imports;
+
+    ///Constructor (an empty relocatable module)
+    ObjectModule() : relocatable(true), size(0u) {}
+    ///Make the module empty (the name is kept).
+    void clear();
+    ///Binary form of the module (the contents of an object file).
+    std::string serialize() const;
+    ///Read the binary form of a module. Returns false (and leaves the module empty) if it is not valid.
+    bool deserialize(const char *data, size_t length);
+    ///Write the module to an object file. Returns false on failure.
+    bool save(const QString &path) const;
+    ///Read the module from an object file. Returns false on failure.
+    bool load(const QString &path);
+};
+
+///Error found while linking.
+struct LinkError : public QException {
+    ///Error message
+    const std::string what;
+    ///Constructor
+    explicit LinkError(const std::string &what) : what(what) {}
+    ///Default copy constructor
+    LinkError(const LinkError &o) = default;
+    ///Virtual destructor required for interop with Qt.
+    virtual ~LinkError() = default;
+
+    /*The following functions are overriden from QException (see SyntaxError).*/
+    void raise() const { throw *this; }
+    LinkError *clone() const {return new LinkError(*this);}
+};
+
+///Combines object modules into one memory image. Relocatable modules are placed one after the other from a base address;
+///symbols imported by a module are looked up among the exports of all the others.
+class Linker {
+public:
+    ///Constructor
+    Linker();
+    ///Place the modules, resolve their imports and apply their relocations. May throw LinkError.
+    void link(const std::vector<const ObjectModule *> &modules, memaddr_t base);
+    ///Address at which each module of the last link was placed (0 for modules which are not relocatable).
+    const std::vector<memaddr_t> &getBases() const {return bases;}
+    ///Memory image built by the last link.
+    const std::vector<data8_t> &getImage() const {return image;}
+    ///Blocks of the image written by the last link, as [start, end) address ranges in ascending order.
+    const std::vector<std::pair<memsize_t, memsize_t>> &getBlocks() const {return blocks;}
+    ///Write the blocks of the last link into processor memory. Memory outside them is left alone.
+    void load(Processor &processor) const;
+private:
+    ///Memory image
+    std::vector<data8_t> image;
+    ///Module (index + 1) which wrote each byte of the image; 0 if none
+    std::vector<unsigned> owner;
+    std::vector<memaddr_t> bases;
+    std::vector<std::pair<memsize_t, memsize_t>> blocks;
+};
+
+#endif // LINKER_H
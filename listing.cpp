@@ -0,0 +1,180 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "listing.h"
+#include "assembler.h"
+#include <algorithm>
+#include <QFile>
+
+//Listing
+
+///Columns of a listing line: line number and marker, address, bytes (BYTES_PER_LINE of them, and a space), source text.
+static const size_t ADDRESS_COLUMN = 7u, BYTES_COLUMN = 13u, SOURCE_COLUMN = 25u;
+
+///Write the hexadecimal digits of value (digits of them) at out.
+static void putHex(char *out, unsigned value, unsigned digits) {
+    for(unsigned k = digits; k > 0u; k--) {out[k-1u] = DIGITS[value & 0xFu]; value >>= 4;}
+}
+
+Listing::Listing() {}
+void Listing::clear() {
+    text.clear(); symbolText.clear(); patches.clear(); references.clear();
+}
+void Listing::startLine(const SourceLine &line) {
+    char prefix[16];
+    std::snprintf(prefix, sizeof(prefix), "%5u%c ", line.lineNumber % 100000u, line.expanded ? '+' : ' ');
+    text.append(prefix);
+}
+void Listing::endLine(const SourceLine &line) {
+    size_t length = line.length;
+    while(length > 0u && (line.text[length-1u] == '\r' || line.text[length-1u] == '\n')) length--;
+    if(length == 0u) {
+        //No trailing blanks on lines without source text (but the bytes still to be filled in stay).
+        const size_t end = text.find_last_not_of(' ') + 1u;
+        text.resize(std::max(end, patches.empty() ? (size_t)0u : patches.back().offset + 3u * patches.back().length - 1u));
+    }
+    else text.append(line.text, length);
+    text.push_back('\n');
+}
+void Listing::addLine(const SourceLine &line) {
+    startLine(line);
+    text.append(SOURCE_COLUMN - ADDRESS_COLUMN, ' ');
+    endLine(line);
+}
+void Listing::addLine(const SourceLine &line, memaddr_t address, memsize_t length) {
+    startLine(line);
+    const size_t start = text.length();
+    text.append(SOURCE_COLUMN - ADDRESS_COLUMN, ' ');
+    putHex(&text[start], address, 4u);
+    memsize_t count = std::min(length, (memsize_t)BYTES_PER_LINE);
+    if(count != 0u) patches.push_back(Patch{start + BYTES_COLUMN - ADDRESS_COLUMN, address, count});
+    endLine(line);
+    //The rest of the bytes go on lines of their own, without source text.
+    for(memsize_t done = count; done < length; done += count) {
+        address = (address + count) & 0xFFFFu;
+        count = std::min(length - done, (memsize_t)BYTES_PER_LINE);
+        text.append(ADDRESS_COLUMN, ' ');
+        const size_t row = text.length();
+        text.append(BYTES_COLUMN - ADDRESS_COLUMN + 3u * count - 1u, ' ');
+        putHex(&text[row], address, 4u);
+        patches.push_back(Patch{row + BYTES_COLUMN - ADDRESS_COLUMN, address, count});
+        text.push_back('\n');
+    }
+}
+void Listing::addValue(const SourceLine &line, data16_t value) {
+    startLine(line);
+    const size_t start = text.length();
+    text.append(SOURCE_COLUMN - ADDRESS_COLUMN, ' ');
+    putHex(&text[start], value, 4u);
+    text[start + BYTES_COLUMN - ADDRESS_COLUMN] = '=';
+    endLine(line);
+}
+void Listing::finish(const std::vector<data8_t> &image, const SymbolTable &symbols, const StringPool &pool) {
+    for(const Patch &patch : patches)
+        for(memsize_t k = 0u; k < patch.length; k++) putHex(&text[patch.offset + 3u * k], image[(patch.address + k) & 0xFFFFu], 2u);
+    patches.clear();
+    //Symbols sorted by name (local labels are qualified by their global label), each with the sorted lines using it.
+    std::sort(references.begin(), references.end());
+    references.erase(std::unique(references.begin(), references.end()), references.end());
+    std::vector<std::pair<std::string, const SymbolTable::Entry *>> names;
+    names.reserve(symbols.size());
+    size_t width = 8u;
+    for(const SymbolTable::Entry &entry : symbols.getEntries()) {
+        const string_id_t scope = (string_id_t)(entry.key >> 32), name = (string_id_t)(entry.key & 0xFFFFFFFFu);
+        names.push_back({std::string(pool.str(scope)) + pool.str(name), &entry});
+        width = std::max(width, names.back().first.length());
+    }
+    std::sort(names.begin(), names.end());
+    symbolText.clear();
+    symbolText.append("SYMBOL").append(width - 6u + 1u, ' ').append("VALUE KIND   LINE REFERENCES\n");
+    for(const std::pair<std::string, const SymbolTable::Entry *> &item : names) {
+        const Symbol &symbol = item.second->symbol;
+        static const char *const kinds[] = {"EXTRN", "LABEL", "EQU", "SET"};
+        char columns[32];
+        if(symbol.isDefined())
+            std::snprintf(columns, sizeof(columns), "%04X%c %-5s %5u", (unsigned)symbol.value, symbol.relocatable ? '\'' : ' ',
+                          kinds[symbol.kind], symbol.lineNumber);
+        else std::snprintf(columns, sizeof(columns), "----  %-5s      ", kinds[symbol.kind]);
+        symbolText.append(item.first).append(width - item.first.length() + 1u, ' ').append(columns);
+        std::vector<std::pair<symbol_key_t, unsigned>>::const_iterator it =
+                std::lower_bound(references.begin(), references.end(), std::make_pair(item.second->key, 0u));
+        for(; it != references.end() && it->first == item.second->key; ++it) symbolText.append(" ").append(unsignedNumber(it->second));
+        const size_t end = symbolText.find_last_not_of(' ');
+        symbolText.resize(end + 1u);
+        symbolText.push_back('\n');
+    }
+}
+bool Listing::save(const QString &listingPath, const QString &symbolPath) const {
+    QFile listingFile(listingPath), symbolFile(symbolPath);
+    if(!listingFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    if(listingFile.write(text.data(), (qint64)text.length()) != (qint64)text.length()) return false;
+    if(!symbolFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    return symbolFile.write(symbolText.data(), (qint64)symbolText.length()) == (qint64)symbolText.length();
+}
+static int hexValue(char ch) {
+    if(ch >= '0' && ch <= '9') return ch - '0';
+    if(ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+bool Listing::parse(const char *text, size_t length, StringPool &pool, std::vector<Instruction> &instructions) {
+    //Only the label and the operand text are taken from the source text; address and bytes are as listed.
+    std::vector<data8_t> arena; std::vector<ExprItem> expressions;
+    Tokenizer tok(nullptr, 0u);
+    LineTranslator translator(tok, &pool, &arena, &expressions);
+    instructions.clear();
+    for(size_t start = 0u; start < length;) {
+        const char *const end = (const char *)std::memchr(text + start, '\n', length - start);
+        const char *const row = text + start; const size_t size = (end != nullptr ? (size_t)(end - row) : length - start);
+        start += size + 1u;
+        if(size == 0u) continue;
+        //Line number (blank on continuation lines) and marker. Lines without source text may end right after the number.
+        const auto at = [&](size_t k) {return k < size ? row[k] : ' ';};
+        if(at(ADDRESS_COLUMN-1u) != ' ' || !(at(ADDRESS_COLUMN-2u) == ' ' || at(ADDRESS_COLUMN-2u) == '+')) return false;
+        unsigned lineNumber = 0u;
+        for(size_t k = 0u; k < ADDRESS_COLUMN - 2u; k++) {
+            if(std::isdigit((unsigned char)at(k))) lineNumber = lineNumber * 10u + (unsigned)(at(k) - '0');
+            else if(at(k) != ' ' || lineNumber != 0u) return false;
+        }
+        if(lineNumber == 0u || size <= SOURCE_COLUMN) continue; //continuation line, or no source text
+        unsigned address = 0u; data8_t bytes[BYTES_PER_LINE]; memsize_t count = 0u;
+        for(size_t k = ADDRESS_COLUMN; k < ADDRESS_COLUMN + 4u; k++) {
+            const int digit = hexValue(row[k]);
+            if(digit < 0) {address = MEMORY_SIZE; break;}
+            address = address * 16u + (unsigned)digit;
+        }
+        if(address == MEMORY_SIZE) continue; //takes up no memory
+        for(; count < BYTES_PER_LINE; count++) {
+            const int high = hexValue(row[BYTES_COLUMN + 3u * count]), low = hexValue(row[BYTES_COLUMN + 3u * count + 1u]);
+            if(high < 0 || low < 0) break;
+            bytes[count] = (data8_t)(high * 16 + low);
+        }
+        if(count == 0u || count > 3u) continue; //EQU, SET, ORG, DS or data
+        tok.reset(row + SOURCE_COLUMN, size - SOURCE_COLUMN);
+        Instruction i;
+        try {i = translator.translateOneLine();} catch (SyntaxError const &) {continue;}
+        if(i.code == nullptr || i.code->isPseudocode || i.code->bytesRequired != count || i.code->code != bytes[0]) continue;
+        i.lineNumber = lineNumber; i.address = (memaddr_t)address;
+        i.operand = count == 1u ? 0u : count == 2u ? bytes[1] : PACK(bytes[2], bytes[1]);
+        i.expression = 0u;
+        instructions.push_back(i);
+    }
+    return true;
+}
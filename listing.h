@@ -0,0 +1,89 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef LISTING_H
+#define LISTING_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <QString>
+#include "commdefs.h"
+#include "stringpool.h"
+#include "symboltable.h"
+
+struct SourceLine;
+struct Instruction;
+
+///Listing (.LST) and symbol (.SYM) files of an assembly run, written while the run goes on rather than from the instructions
+///afterwards. Every line of the listing holds the line number, a '+' for lines of macro expansions and included files, the
+///address (or the value, for EQU and SET), up to four bytes, and the source text:
+///
+///       12+ 0803  3E 05       MVI A, 5
+///
+///Lines with more bytes continue on lines of their own. The bytes are filled in by finish(), once forward references are
+///resolved. The symbol file lists every symbol with its value, kind, the line defining it and the lines using it.
+class Listing {
+public:
+    ///Constructor (empty listing)
+    Listing();
+    ///Forget everything (called by the assembler at the start of a run).
+    void clear();
+    ///List a line which takes up no memory (comments, directives and skipped lines).
+    void addLine(const SourceLine &line);
+    ///List a line which lays out length bytes at address (0 bytes for ORG and DS, which only show the address).
+    void addLine(const SourceLine &line, memaddr_t address, memsize_t length);
+    ///List a line which defines a symbol (EQU or SET) with the given value.
+    void addValue(const SourceLine &line, data16_t value);
+    ///Note that a line uses a symbol.
+    void addReference(symbol_key_t key, unsigned lineNumber) {references.push_back({key, lineNumber});}
+    ///Fill in the bytes from the memory image of the run, and write the symbol file.
+    void finish(const std::vector<data8_t> &image, const SymbolTable &symbols, const StringPool &pool);
+    ///Text of the listing file.
+    const std::string &getText() const {return text;}
+    ///Text of the symbol file (empty until finish()).
+    const std::string &getSymbols() const {return symbolText;}
+    ///Write the listing and the symbol file. Returns false on failure.
+    bool save(const QString &listingPath, const QString &symbolPath) const;
+    ///Read the instructions back from the text of a listing (for the debug table). Labels and operand texts are interned in
+    ///pool; data lines are skipped. Returns false if the text is not a listing.
+    static bool parse(const char *text, size_t length, StringPool &pool, std::vector<Instruction> &instructions);
+private:
+    ///Bytes shown on one line of the listing.
+    static const memsize_t BYTES_PER_LINE = 4u;
+    ///Bytes still to be filled in: where they go in text, and where they are in the image.
+    struct Patch {
+        size_t offset;
+        memaddr_t address;
+        memsize_t length;
+    };
+    std::string text, symbolText;
+    std::vector<Patch> patches;
+    ///Symbols used, and by which lines.
+    std::vector<std::pair<symbol_key_t, unsigned>> references;
+
+    ///Start a line of the listing, up to the address.
+    void startLine(const SourceLine &line);
+    ///Append the source text of a line, and end the line.
+    void endLine(const SourceLine &line);
+};
+
+#endif // LISTING_H
@@ -28,7 +28,10 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow), processor(new Processor(this)), assembler(new Assembler(processor)),
       memTable(new MemoryTableModel(processor, processor)), ioTable(new IOTableModel(processor, processor)),
-      emptyDebugTableModel(new DebugTableModel(this)), isFileModified(0), settings(new QSettings(this))
+      disassemblyTable(new DisassemblyModel(processor, processor)), emptyDebugTableModel(new DebugTableModel(this)), isFileModified(0), settings(new QSettings(this)),
+      timer(new Timer8253(processor)), serialEndpoint(new BufferedSerialEndpoint(256, this)),
+      usart(new Usart8251(processor, serialEndpoint, 320u)), serialLine(new SerialLineUart(processor, serialEndpoint, 320u)),
+      ppi(new PPI8255()), keyboard(new Keyboard8279(processor, 20, this))
 {
     //Call 'uic mainwindow.ui' and look at the contents of the generated file. UIC is a tool available in the Qt system alongwith
     //QMake and MOC.
@@ -44,15 +47,25 @@ MainWindow::MainWindow(QWidget *parent)
     */
     findDialog = new FindDialog(this, ui->source);
     highlighter = new SyntaxHighlighter(ui->source->document());
+    backgroundAssembler = new BackgroundAssembler(ui->source->document(), this);
+    connect(backgroundAssembler, &BackgroundAssembler::diagnosticsReady, this, [&](std::vector<SyntaxError> diagnostics) {
+        QList<int> lines;
+        for(const SyntaxError &ex : diagnostics) if(ex.lineNumber > 0) lines.append((int)ex.lineNumber);
+        ui->source->setErrorLines(lines);
+        if(!diagnostics.empty()) ui->statusbar->showMessage(constructAssemblyError(diagnostics.front()));
+    });
     connect(this, &MainWindow::__fireAssemblerEvent, assembler, &Assembler::assemble);
     connect(assembler, &Assembler::assemblyFinished, this, &MainWindow::assemblyFinished);
-    connect(assembler, &Assembler::assemblyError, this, &MainWindow::assemblyError);
+    connect(assembler, &Assembler::assemblyErrors, this, &MainWindow::assemblyError);
 
     //Memory and I/O tables
     ui->memTableView->setModel(memTable);
     ui->memTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     ui->ioTableView->setModel(ioTable);
     ui->ioTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->disassemblyTableView->setModel(disassemblyTable);
+    ui->disassemblyTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->disassemblyTableView->verticalHeader()->hide(); //rows are addresses, not lines
 
     //Current empty debug table
     currentDebugTableModel = emptyDebugTableModel;
@@ -94,6 +107,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->actionOpen_Source_File, &QAction::triggered, this, &MainWindow::openFile);
     connect(ui->actionSave_Source_File, &QAction::triggered, this, &MainWindow::saveFile);
     connect(ui->actionSave_Source_File_As, &QAction::triggered, this, &MainWindow::saveFileAs);
+    connect(ui->actionSave_Listing, &QAction::triggered, this, &MainWindow::saveListing);
+    connect(ui->actionOpen_Listing, &QAction::triggered, this, &MainWindow::openListing);
+    connect(ui->actionLoad_ROM, &QAction::triggered, this, &MainWindow::loadROM);
     connect(ui->actionFull_Screen, &QAction::toggled, this, &MainWindow::fullScreen);
     connect(ui->actionExit, &QAction::triggered, this, &MainWindow::close);
 
@@ -136,8 +152,42 @@ MainWindow::MainWindow(QWidget *parent)
     connect(processor, &Processor::halted, this, &MainWindow::halted);
     connect(processor, &Processor::unusedInstruction, this,
             [&](data8_t value){ui->statusbar->showMessage(tr("Unused instruction ") + QString::number(value, 16) + tr(" encountered"));});
+    connect(processor, &Processor::romWriteTrapped, this,
+            [&](memaddr_t address){ui->statusbar->showMessage(tr("Write to ROM at ") + getHex16(address) + tr("H trapped"));});
 
     connect(ui->actionFont, &QAction::triggered, this, &MainWindow::font);
+    connect(ui->actionAttach_8253_Timer, &QAction::toggled, this, &MainWindow::timerAttached);
+    connect(ui->actionAttach_Serial_Console, &QAction::toggled, this, &MainWindow::serialConsoleAttached);
+    connect(ui->actionSerial_Line_Timing, &QAction::triggered, this, &MainWindow::serialLineTiming);
+
+    //Serial console. Characters sent by the program are shown a line (or a buffer) at a time; the rest is flushed when the
+    //program halts or after a single step.
+    serialConsole = new SerialConsole();
+    serialDock = new QDockWidget(tr("Serial Console"), this);
+    serialDock->setObjectName("serialDock");
+    serialDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable); //closed through the Options menu
+    serialDock->setWidget(serialConsole);
+    addDockWidget(Qt::BottomDockWidgetArea, serialDock);
+    serialDock->hide();
+    connect(serialEndpoint, &BufferedSerialEndpoint::outputReady, serialConsole, &SerialConsole::appendOutput);
+    connect(serialConsole, &SerialConsole::inputTyped, serialEndpoint, &BufferedSerialEndpoint::feedInput);
+    connect(processor, &Processor::halted, serialEndpoint, &BufferedSerialEndpoint::flush);
+    connect(ui->stepButton, &QPushButton::clicked, serialEndpoint, &BufferedSerialEndpoint::flush); //after the step itself
+
+    //Trainer panel. The display is redrawn at most once per refresh period of the 8279, however often the program writes it.
+    connect(ui->actionAttach_Trainer_Panel, &QAction::toggled, this, &MainWindow::trainerPanelAttached);
+    trainerPanel = new TrainerPanel();
+    trainerDock = new QDockWidget(tr("Trainer Panel"), this);
+    trainerDock->setObjectName("trainerDock");
+    trainerDock->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable); //closed through the Options menu
+    trainerDock->setWidget(trainerPanel);
+    addDockWidget(Qt::RightDockWidgetArea, trainerDock);
+    trainerDock->hide();
+    connect(keyboard, &Keyboard8279::displayUpdated, trainerPanel->getDisplay(), &SevenSegmentDisplay::setCharacters);
+    //Key presses arrive between two instructions (the processor polls the event loop), so the key lands at the current cycle.
+    connect(trainerPanel, &TrainerPanel::keyPressed, this, [&](data8_t code){keyboard->pressKey(code);});
+    connect(trainerPanel, &TrainerPanel::resetPressed, processor, &Processor::RESET_IN);
+    connect(trainerPanel, &TrainerPanel::vectorInterruptPressed, this, [&](){processor->setRestart7_5Request(true);});
 
     connect(ui->findTarget, &QLineEdit::editingFinished, this, [&](){
         unsigned target = ui->findTarget->text().toUInt(nullptr, 16);
@@ -237,8 +287,20 @@ MainWindow::MainWindow(QWidget *parent)
     ui->source->setFont(settings->value("source/font", ui->source->font()).value<QFont>());
     ui->actionDisplay_Dialog_Box_on_Source_Code_Errors->setChecked(settings->value("source/displayDialogBoxOnSourceCodeErrors",
         ui->actionDisplay_Dialog_Box_on_Source_Code_Errors->isChecked()).value<bool>());
+    ui->actionAttach_8253_Timer->setChecked(settings->value("devices/timer8253", false).value<bool>());
+    const cycles_t cyclesPerBit = settings->value("devices/serialCyclesPerBit", 320u).value<unsigned>();
+    usart->setCyclesPerBit(cyclesPerBit); serialLine->setCyclesPerBit(cyclesPerBit);
+    ui->actionAttach_Serial_Console->setChecked(settings->value("devices/serialConsole", false).value<bool>());
+    ui->actionAttach_Trainer_Panel->setChecked(settings->value("devices/trainerPanel", false).value<bool>());
+}
+MainWindow::~MainWindow(){
+    processor->clearScheduledEvents(); //they may refer to the devices
+    delete timer;
+    delete usart;
+    delete serialLine;
+    delete ppi;
+    delete ui;
 }
-MainWindow::~MainWindow(){delete ui;}
 
 //protected
 void MainWindow::closeEvent(QCloseEvent *evt) {
@@ -258,6 +320,10 @@ void MainWindow::closeEvent(QCloseEvent *evt) {
     settings->setValue("directory", QDir::currentPath());
     settings->setValue("source/font", ui->source->font());
     settings->setValue("source/displayDialogBoxOnSourceCodeErrors", ui->actionDisplay_Dialog_Box_on_Source_Code_Errors->isChecked());
+    settings->setValue("devices/timer8253", ui->actionAttach_8253_Timer->isChecked());
+    settings->setValue("devices/serialConsole", ui->actionAttach_Serial_Console->isChecked());
+    settings->setValue("devices/serialCyclesPerBit", (unsigned)usart->getCyclesPerBit());
+    settings->setValue("devices/trainerPanel", ui->actionAttach_Trainer_Panel->isChecked());
     settings->sync();
     QMainWindow::closeEvent(evt);
 }
@@ -282,26 +348,28 @@ void MainWindow::runOneShot() {
 void MainWindow::halted() {ui->statusbar->showMessage(tr("Processor execution halted"));}
 
 #include <vector>
-#include <sstream>
 void MainWindow::assemble() {
     lastAssemblyErrored = 0;
     ui->statusbar->showMessage(tr("Assembling..."));
-    processor->resetAll();
-    assembler->in = new std::stringstream(ui->source->toPlainText().toStdString());
+    ui->actionSave_Listing->setEnabled(false); //until this assembly finishes
+    //Memory is not cleared here; the assembler only rewrites the bytes that differ from the new program.
+    processor->RESET_IN(); processor->resetIOPorts();
+    assembler->source = ui->source->toPlainText().toStdString();
     ui->sourceTab->setDisabled(true); //source disabled while assembling
     ui->debugTab->setDisabled(true); //debug disabled while assembling
     ui->memoryTab->setDisabled(true); //memory disabled while assembling
     emit __fireAssemblerEvent();
 }
 void MainWindow::assemblyFinished() {
-    delete assembler->in;
+    ui->source->setErrorLine(0);
     ui->sourceTab->setDisabled(false);
     ui->debugTab->setDisabled(false);
     ui->memoryTab->setDisabled(false);
+    ui->actionSave_Listing->setEnabled(true);
     if(currentDebugTableModel != emptyDebugTableModel) currentDebugTableModel->deleteLater();
-    currentDebugTableModel = new DebugTableModel(this, assembler->instructions);
-    //For convenience set ui->runTarget to the lowest address.
-    if(assembler->instructions.size() > 0) ui->runTarget->setText(getHex16(assembler->instructions[0].address));
+    currentDebugTableModel = new DebugTableModel(this, assembler->instructions, assembler->getStringPool());
+    //For convenience set ui->runTarget to the lowest address (the debug table is sorted by address).
+    if(currentDebugTableModel->list.size() > 0) ui->runTarget->setText(getHex16(currentDebugTableModel->list[0].address));
     else {
         ui->runTarget->setText("");
         lastAssemblyErrored = 1;
@@ -329,9 +397,9 @@ void MainWindow::runTargetUpdated() {
 #include <QTextCursor>
 #include <QTextBlock>
 #include <QMessageBox>
-void MainWindow::assemblyError(SyntaxError ex) {
+void MainWindow::assemblyError(std::vector<SyntaxError> diagnostics) {
+    const SyntaxError &ex = diagnostics.front();
     lastAssemblyErrored = 1;
-    delete assembler->in;
     ui->sourceTab->setDisabled(false);
     ui->debugTab->setDisabled(false);
     ui->memoryTab->setDisabled(false);
@@ -339,9 +407,12 @@ void MainWindow::assemblyError(SyntaxError ex) {
     if(ex.lineNumber > 0) cursor.setPosition(ui->source->document()->findBlockByLineNumber(ex.lineNumber-1).position());
     if(ex.columnNumber > 0) cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, ex.columnNumber-1);
     ui->source->setTextCursor(cursor);*/
-    ui->source->setErrorLine(ex.lineNumber);
+    QList<int> lines;
+    for(const SyntaxError &error : diagnostics) if(error.lineNumber > 0) lines.append((int)error.lineNumber);
+    ui->source->setErrorLines(lines);
     ui->leftWidget->setCurrentWidget(ui->sourceTab);
     QString msg(constructAssemblyError(ex));
+    if(diagnostics.size() > 1) msg += tr(" (and %1 more errors)").arg((qint64)diagnostics.size() - 1);
     ui->statusbar->showMessage(msg);
     if(ui->actionDisplay_Dialog_Box_on_Source_Code_Errors->isChecked()) QMessageBox::critical(this, tr("Source Code Error!"), msg, QMessageBox::Ok, QMessageBox::Ok);
 }
@@ -480,6 +551,81 @@ saveFileAsRetry:
     ui->source->document()->setModified(false); fileModified(false);
     QDir::setCurrent(currentlyOpenedFile.dir().absolutePath());
 }
+void MainWindow::saveListing() {
+    //The symbol file goes next to the listing, with the same name and the .sym extension.
+    QString name = QFileDialog::getSaveFileName(this, tr("Save Listing"), currentlyOpenedFile.isFile()
+                                                ? currentlyOpenedFile.dir().absoluteFilePath(currentlyOpenedFile.completeBaseName() + ".lst")
+                                                : QDir::currentPath(),
+                                                tr("8085 Assembly Listing Files (*.lst);;All Files (*.*)"));
+    if(name.isNull()) return; //operation cancelled.
+    QFileInfo listing(name);
+    QString symbols = listing.dir().absoluteFilePath(listing.completeBaseName() + ".sym");
+    if(!assembler->assemblyListing.save(listing.absoluteFilePath(), symbols)) {
+        QMessageBox::critical(this, tr("Error!"),
+                              tr("The listing could not be written to ")+listing.absoluteFilePath()+tr(" and ")+symbols+tr("."),
+                              QMessageBox::Ok, QMessageBox::Ok);
+        return;
+    }
+    ui->statusbar->showMessage(tr("Listing saved to ") + listing.absoluteFilePath() + tr(" and ") + symbols);
+}
+void MainWindow::openListing() {
+    QString name = QFileDialog::getOpenFileName(this, tr("Open Listing"), QDir::currentPath(),
+                                                tr("8085 Assembly Listing Files (*.lst);;All Files (*.*)"));
+    if(name.isNull()) return; //operation cancelled.
+    DebugTableModel *model = DebugTableModel::fromListing(name, this);
+    if(model == nullptr) {
+        QMessageBox::critical(this, tr("Error!"),
+                              tr("The selected file ")+QFileInfo(name).absoluteFilePath()+tr(" is not a readable listing."),
+                              QMessageBox::Ok, QMessageBox::Ok);
+        return;
+    }
+    showDebugTable(model);
+    ui->statusbar->showMessage(tr("Listing opened (memory is not changed)"));
+}
+#include "disassembler.h"
+void MainWindow::loadROM() {
+    QString name = QFileDialog::getOpenFileName(this, tr("Load ROM"), QDir::currentPath(),
+                                                tr("Binary Files (*.bin *.rom);;All Files (*.*)"));
+    if(name.isNull()) return; //operation cancelled.
+    bool ok;
+    QString start = QInputDialog::getText(this, tr("Load ROM"), tr("Load Address (hexadecimal):"), QLineEdit::Normal,
+                                          QString("0000"), &ok);
+    if(!ok) return;
+    unsigned address = start.trimmed().toUInt(&ok, 16);
+    if(!ok || address > 0xFFFFu) {
+        QMessageBox::critical(this, tr("Error!"), tr("Expected an address between 0000 and FFFF."), QMessageBox::Ok, QMessageBox::Ok);
+        return;
+    }
+    Disassembler disassembler; memsize_t length;
+    if(!disassembler.loadFile(name, (memaddr_t)address, length)) {
+        QMessageBox::critical(this, tr("Error!"),
+                              tr("The selected file ")+QFileInfo(name).absoluteFilePath()+tr(" is not readable or is larger than 64KiB."),
+                              QMessageBox::Ok, QMessageBox::Ok);
+        return;
+    }
+    //Only code reachable from the load address is decoded; everything else is data. Bytes past FFFFH wrap around to 0000H in
+    //memory, but are not disassembled.
+    const memsize_t end = address + length < MEMORY_SIZE ? address + length : MEMORY_SIZE;
+    disassembler.disassemble(address, end, Disassembler::RECURSIVE_DESCENT);
+    const std::vector<data8_t> &image = disassembler.getImage();
+    processor->RESET_IN(); //as after assembly
+    processor->overwrite(image.data() + address, (memaddr_t)address, end - address);
+    if(address + length > MEMORY_SIZE) processor->overwrite(image.data(), 0u, address + length - MEMORY_SIZE);
+    showDebugTable(new DebugTableModel(this, disassembler.getInstructions(), disassembler.getStringPool()));
+    ui->statusbar->showMessage(tr("Loaded ") + QString::number(length) + tr(" bytes at ") + getHex16(address) + tr("H"));
+}
+void MainWindow::showDebugTable(DebugTableModel *model) {
+    if(currentDebugTableModel != emptyDebugTableModel) currentDebugTableModel->deleteLater();
+    currentDebugTableModel = model;
+    ui->debugTableView->setModel(currentDebugTableModel);
+    //As after assembly, set ui->runTarget to the lowest address (the debug table is sorted by address).
+    if(currentDebugTableModel->list.size() > 0) {
+        ui->runTarget->setText(getHex16(currentDebugTableModel->list[0].address));
+        runTargetUpdated();
+    }
+    else programCounterChanged(); //nothing to highlight
+    ui->leftWidget->setCurrentWidget(ui->debugTab);
+}
 void MainWindow::fullScreen(bool flag) {
     setWindowFlag(Qt::FramelessWindowHint, flag);
     if(flag) {showFullScreen();} else {showNormal();}
@@ -489,6 +635,62 @@ void MainWindow::font() {
     QFont font = QFontDialog::getFont(&ok, ui->source->font(), this, tr("Choose Editor Font"));
     if(ok) ui->source->setFont(font);
 }
+void MainWindow::timerAttached(bool attached) {
+    if(attached) {
+        //As on the lab kits: OUT0 raises RST 7.5, OUT1 RST 6.5 and OUT2 TRAP.
+        processor->attachIODevice(0x10u, 4u, timer);
+        timer->connectOutput(0u, RST7_5_LINE);
+        timer->connectOutput(1u, RST6_5_LINE);
+        timer->connectOutput(2u, TRAP_LINE);
+        ui->statusbar->showMessage(tr("8253 timer attached to ports 10H to 13H"));
+    }
+    else {
+        for(unsigned i = 0; i < Timer8253::COUNTERS; i++) timer->connectOutput(i, NO_INTERRUPT); //releases the lines
+        processor->detachIODevice(timer);
+        ui->statusbar->showMessage(tr("8253 timer detached"));
+    }
+}
+void MainWindow::serialConsoleAttached(bool attached) {
+    if(attached) {
+        processor->attachIODevice(0x08u, 2u, usart);
+        processor->attachSerialLineDevice(serialLine);
+        ui->statusbar->showMessage(tr("Serial console attached to the 8251 (ports 08H and 09H) and to SOD/SID"));
+    }
+    else {
+        serialEndpoint->flush(); //show what is left
+        processor->detachIODevice(usart);
+        processor->attachSerialLineDevice(nullptr);
+        serialEndpoint->clearInput();
+        ui->statusbar->showMessage(tr("Serial console detached"));
+    }
+    serialDock->setVisible(attached);
+}
+void MainWindow::serialLineTiming() {
+    bool ok;
+    int cyclesPerBit = QInputDialog::getInt(this, tr("Serial Line Timing"),
+                                            tr("Clock cycles (T-states) per bit, for the 8251 and SOD/SID\n"
+                                               "(320 is 9600 baud at 3.072 MHz):"),
+                                            (int)usart->getCyclesPerBit(), 1, 1000000, 1, &ok);
+    if(!ok) return;
+    usart->setCyclesPerBit((cycles_t)cyclesPerBit);
+    serialLine->setCyclesPerBit((cycles_t)cyclesPerBit);
+}
+void MainWindow::trainerPanelAttached(bool attached) {
+    if(attached) {
+        processor->attachIODevice(0x00u, 4u, ppi);
+        processor->attachIODevice(0x18u, 2u, keyboard); //data at 18H, command/status at 19H
+        keyboard->connectInterrupt(RST5_5_LINE); //IRQ is wired to RST 5.5 on the SDK-85
+        trainerPanel->getDisplay()->setCharacters(keyboard->getDisplay());
+        ui->statusbar->showMessage(tr("Trainer panel attached: 8255 on ports 00H to 03H, 8279 on ports 18H and 19H"));
+    }
+    else {
+        keyboard->connectInterrupt(NO_INTERRUPT);
+        processor->detachIODevice(ppi);
+        processor->detachIODevice(keyboard);
+        ui->statusbar->showMessage(tr("Trainer panel detached"));
+    }
+    trainerDock->setVisible(attached);
+}
 void MainWindow::accumulatorChanged() {
     ui->accumulatorFull->setText(getHex8(processor->getAccumulator()));
     ui->accumulator7->setText(getBinDigit(processor->getAccumulator(), 7));
@@ -581,21 +783,15 @@ void MainWindow::registerLChanged() {
     ui->registerL0->setText(getBinDigit(processor->getLRegister(), 0));
     ui->registerHL->setText(getHex16(processor->getHLRegisterPair()));
 }
-#include <algorithm>
 void MainWindow::programCounterChanged() {
     ui->programCounter->setText(getHex16(processor->getProgramCounter()));
     if(ui->followPC->isChecked())
         ui->memTableView->setCurrentIndex(memTable->index((processor->getProgramCounter() >> 4) & 0xFFF, processor->getProgramCounter() & 0xF));
-    Instruction dummy; dummy.address = processor->getProgramCounter();
-    //upper_bound can also be used. Both are guaranteed to be O(log n).
-    std::vector<Instruction>::iterator location = std::lower_bound(currentDebugTableModel->list.begin(),
-                                                                     currentDebugTableModel->list.end(),
-                                                                     dummy, InstructionAddressComparator());
-    if(location == currentDebugTableModel->list.end() || location->address != processor->getProgramCounter()) currentDebugTableModel->setHighlightedIndex(-1);
-    else {
-        currentDebugTableModel->setHighlightedIndex(location - currentDebugTableModel->list.begin());
-        ui->debugTableView->setCurrentIndex(currentDebugTableModel->index(location - currentDebugTableModel->list.begin(), 2));
-    }
+    if(ui->disassemblyFollowPC->isChecked())
+        ui->disassemblyTableView->setCurrentIndex(disassemblyTable->index(disassemblyTable->rowOf(processor->getProgramCounter()), 1));
+    const int row = currentDebugTableModel->rowOf(processor->getProgramCounter()); //one array load
+    currentDebugTableModel->setHighlightedIndex(row);
+    if(row != -1) ui->debugTableView->setCurrentIndex(currentDebugTableModel->index(row, 2));
 }
 void MainWindow::stackPointerChanged() {ui->stackPointer->setText(getHex16(processor->getStackPointer()));}
 void MainWindow::MChanged() {
@@ -10,11 +10,22 @@
 #include "opcodes.h"
 #include "processor.h"
 #include "assembler.h"
+#include "backgroundassembler.h"
 #include "memorymodel.h"
+#include "disassemblymodel.h"
 #include "iomodel.h"
 #include "debugtable.h"
 #include "syntaxhighlighter.h"
 #include "finddialog.h"
+#include "timer8253.h"
+#include "serialendpoint.h"
+#include "usart8251.h"
+#include "seriallineuart.h"
+#include "serialconsole.h"
+#include "ppi8255.h"
+#include "keyboard8279.h"
+#include "trainerpanel.h"
+#include <QDockWidget>
 
 //We will use Qt's file handling features because they correctly handle various file encodings (UTF-8 or ISOxxx, etc...)
 #include <QFileInfo>
@@ -46,8 +57,8 @@ private slots:
     void assemble();
     ///Assembly finished successfully
     void assemblyFinished();
-    ///Assembly resulted in an error.
-    void assemblyError(SyntaxError ex);
+    ///Assembly resulted in errors (all of them, in line order).
+    void assemblyError(std::vector<SyntaxError> diagnostics);
     ///User requested a line in source to go to
     void goToLine();
     ///ui->runTarget field has been updated
@@ -86,11 +97,25 @@ private slots:
     void saveFile();
     ///User requested to save file As...
     void saveFileAs();
+    ///User requested to save the listing and symbol file of the last assembly.
+    void saveListing();
+    ///User requested to open a listing into the debug table.
+    void openListing();
+    ///User requested to load a binary (ROM) file into memory and disassemble it into the debug table.
+    void loadROM();
     ///User toggled full screen check box menu.
     void fullScreen(bool);
 
     ///User requested a font change.
     void font();
+    ///User attached (or detached) the 8253 timer.
+    void timerAttached(bool attached);
+    ///User attached (or detached) the serial console: the 8251 USART and the SOD/SID UART, both connected to it.
+    void serialConsoleAttached(bool attached);
+    ///User requested to change the bit time of the serial lines.
+    void serialLineTiming();
+    ///User attached (or detached) the trainer panel: the 8255 PPI and the 8279 keyboard/display controller.
+    void trainerPanelAttached(bool attached);
 
     ///Fired when the accumulator register is changed.
     void accumulatorChanged();
@@ -147,6 +172,8 @@ private slots:
 
     ///Check if currentlyOpenedFile was modified and offer to save. Returns false if entire operation was cancelled.
     bool checkUnsaved();
+    ///Show model in the debug table (which takes ownership of it) and set ui->runTarget to its lowest address.
+    void showDebugTable(DebugTableModel *model);
 signals:
     //WARNING: TREAT THE FOLLOWING AS PRIVATE API
     ///Fire event to signal assembler to begin assembling.
@@ -164,10 +191,14 @@ private:
     MemoryTableModel * const memTable;
     ///Table model for displaying I/O ports to user
     IOTableModel * const ioTable;
+    ///Table model for displaying all of memory disassembled (follows changes to memory)
+    DisassemblyModel * const disassemblyTable;
     ///A default model for the debugging information table (ui->debugTable) which is empty.
     DebugTableModel * const emptyDebugTableModel;
     ///Table model for displaying debugging information to user.
     DebugTableModel *currentDebugTableModel; //Not const because can change
+    ///Continuous checking of the source while the user types
+    BackgroundAssembler *backgroundAssembler; //Not const for the same reason as highlighter
     ///Syntax highlighter engine
     SyntaxHighlighter *highlighter; //Not const because it depends upon components initialized AFTER const initialization
     ///Currently opened file info
@@ -182,5 +213,25 @@ private:
     QSettings * const settings;
     ///Find dialog (NOT const because depends upon ui->source)
     FindDialog *findDialog;
+    ///8253 timer of the lab kits; on ports 10H to 13H while attached (see timerAttached()).
+    Timer8253 * const timer;
+    ///Host side of the serial lines (see serialConsoleAttached()).
+    BufferedSerialEndpoint * const serialEndpoint;
+    ///8251 USART of the lab kits; on ports 08H and 09H while the serial console is attached.
+    Usart8251 * const usart;
+    ///Bit-banged UART on the SOD and SID pins while the serial console is attached.
+    SerialLineUart * const serialLine;
+    ///Terminal showing serialEndpoint (NOT const for the same reason as findDialog)
+    SerialConsole *serialConsole;
+    ///Dock holding serialConsole; visible while the serial console is attached.
+    QDockWidget *serialDock;
+    ///8255 PPI of the trainer kits; on ports 00H to 03H while the trainer panel is attached.
+    PPI8255 * const ppi;
+    ///8279 keyboard/display controller of the trainer kits; on ports 18H and 19H while the trainer panel is attached.
+    Keyboard8279 * const keyboard;
+    ///Display and keypad of the trainer (NOT const for the same reason as findDialog)
+    TrainerPanel *trainerPanel;
+    ///Dock holding trainerPanel; visible while the trainer panel is attached.
+    QDockWidget *trainerDock;
 };
 #endif // MAINWINDOW_H
@@ -331,44 +331,170 @@ const opcode *opcodesByCode[256] = {
     &RM      , &SPHL    , &JM      , &EI      , &CM      , nullptr  , &CPI     , &RST_7
 };
 
-#include <set>
-#include <iostream>
+const data8_t tStatesByCode[256] = {
+    //Implementation Note: values are from the Intel 8085 instruction set summary. Conditional returns, jumps and calls list
+    //the count for a condition which is NOT met; see TSTATES_EXTRA_ON_CONDITION_MET. Unused opcodes are given 4 (a bare
+    //opcode fetch).
+     4, 10,  7,  6,  4,  4,  7,  4,  4, 10,  7,  6,  4,  4,  7,  4,
+     4, 10,  7,  6,  4,  4,  7,  4,  4, 10,  7,  6,  4,  4,  7,  4,
+     4, 10, 16,  6,  4,  4,  7,  4,  4, 10, 16,  6,  4,  4,  7,  4,
+     4, 10, 13,  6, 10, 10, 10,  4,  4, 10, 13,  6,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     7,  7,  7,  7,  7,  7,  5,  7,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+     6, 10,  7, 10,  9, 12,  7, 12,  6, 10,  7,  4,  9, 18,  7, 12,
+     6, 10,  7, 10,  9, 12,  7, 12,  6,  4,  7, 10,  9,  4,  7, 12,
+     6, 10,  7, 16,  9, 12,  7, 12,  6,  6,  7,  4,  9,  4,  7, 12,
+     6, 10,  7,  4,  9, 12,  7, 12,  6,  6,  7,  4,  9,  4,  7, 12
+};
 
-bool isOpcode(const char * const name) {
-    static std::set<const char *, CaseInsensitive> nameSet;
-    if(nameSet.empty()) {
-        for(data8_calc_t i = 0; i < 256; i++)
-            if(opcodesByCode[i] != nullptr) nameSet.insert(opcodesByCode[i]->mnemonic);
+const opcode ORG        ("ORG");
+const opcode DATA       ("DATA");
+const opcode EQU        ("EQU");
+const opcode SET        ("SET");
+const opcode DB         ("DB");
+const opcode DW         ("DW");
+const opcode DS         ("DS");
+const opcode INCBIN     ("INCBIN");
+const opcode MACRO      ("MACRO");
+const opcode ENDM       ("ENDM");
+const opcode REPT       ("REPT");
+const opcode IRP        ("IRP");
+const opcode IF         ("IF");
+const opcode ELSE       ("ELSE");
+const opcode ENDIF      ("ENDIF");
+const opcode INCLUDE    ("INCLUDE");
+
+#include <vector>
+#include <algorithm>
+
+///Pseudocodes known to the assembler, in the order their mnemonic identifiers are assigned (after all opcode mnemonics).
+static const opcode *const pseudocodes[] = {&ORG, &DATA, &EQU, &SET, &DB, &DW, &DS, &INCBIN,
+                                            &MACRO, &ENDM, &REPT, &IRP, &IF, &ELSE, &ENDIF, &INCLUDE};
+
+///Pack up to MNEMONIC_MAX_LENGTH characters into a 64-bit key, upper-casing letters (character i goes into byte i). Mnemonics
+///are alphanumeric, so two texts have the same key only if they are the same mnemonic. Returns 0 (never a valid key) if the
+///text is empty or too long.
+static inline uint_fast64_t packMnemonic(const char *s, size_t length) {
+    if(length == 0 || length > MNEMONIC_MAX_LENGTH) return 0u;
+    uint_fast64_t key = 0u;
+    for(size_t i = 0; i < length; i++) {
+        const unsigned char ch = (unsigned char)s[i];
+        key |= (uint_fast64_t)(ch >= 'a' && ch <= 'z' ? ch - ('a' - 'A') : ch) << (8u * i);
     }
-    return nameSet.find(name) != nameSet.end();
+    return key;
+}
+///64-bit mixing function (finalizer of MurmurHash3).
+static inline uint_fast64_t mixMnemonic(uint_fast64_t key) {
+    key ^= key >> 33; key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33; key *= 0xC4CEB9FE1A85EC53ull;
+    key ^= key >> 33;
+    return key;
 }
 
-#include <map>
+///Perfect hash over all mnemonics ("hash and displace"). Keys are first split into buckets by one hash; every bucket then gets
+///a displacement chosen while building so that the second hash puts each of its keys into a slot no other key uses. A lookup
+///therefore touches exactly one slot.
+struct MnemonicTable {
+    ///Number of first-level buckets.
+    static const unsigned BUCKETS = 64u;
+    ///Number of slots (must be a power of 2 and comfortably larger than the number of mnemonics).
+    static const unsigned SLOTS = 512u;
+    ///Displacement for each bucket.
+    data16_t displacement[BUCKETS];
+    ///Packed key stored in each slot (0 if the slot is empty).
+    uint_fast64_t slotKey[SLOTS];
+    ///Mnemonic identifier stored in each slot.
+    mnemonic_t slotId[SLOTS];
+    ///Text of each mnemonic, indexed by identifier.
+    std::vector<const char *> names;
+    ///Opcode identified by the mnemonic alone (or nullptr), indexed by identifier.
+    std::vector<const opcode *> opcodes;
+    ///Number of opcode mnemonics; identifiers from here on are pseudocodes.
+    mnemonic_t firstPseudocode;
 
-const opcode *getOpcode(const char * const name) {
-    static std::map<const char *, const opcode *, CaseInsensitive> nameMap;
-    static CaseInsensitive comparator;
-    if(nameMap.empty()) {
-        for(data8_calc_t i = 0; i < 256; i++)
-            if(opcodesByCode[i] != nullptr &&
-                !comparator(opcodesByCode[i]->mnemonic, opcodesByCode[i]->name) &&
-                    !comparator(opcodesByCode[i]->name, opcodesByCode[i]->mnemonic)) nameMap.insert({opcodesByCode[i]->name, opcodesByCode[i]});
+    static unsigned bucketOf(uint_fast64_t key) {return (unsigned)(mixMnemonic(key) & (BUCKETS-1u));}
+    static unsigned slotOf(uint_fast64_t key, data16_t d) {return (unsigned)((mixMnemonic(key ^ ((uint_fast64_t)d << 56) ^ d) >> 20) & (SLOTS-1u));}
+
+    MnemonicTable() {
+        std::vector<uint_fast64_t> keys;
+        //Collect distinct mnemonics in bytecode order.
+        for(data8_calc_t i = 0; i < 256; i++) {
+            const opcode *op = opcodesByCode[i];
+            if(op == nullptr) continue;
+            const uint_fast64_t key = packMnemonic(op->mnemonic, std::strlen(op->mnemonic));
+            size_t id = 0;
+            while(id < keys.size() && keys[id] != key) id++;
+            //Only mnemonics like NOP (whose name is the mnemonic itself) identify an opcode without operands.
+            const opcode *const direct = std::strcmp(op->mnemonic, op->name) == 0 ? op : nullptr;
+            if(id == keys.size()) {keys.push_back(key); names.push_back(op->mnemonic); opcodes.push_back(direct);}
+            else if(direct != nullptr) opcodes[id] = direct;
+        }
+        firstPseudocode = (mnemonic_t)keys.size();
+        for(const opcode *op : pseudocodes) {
+            keys.push_back(packMnemonic(op->mnemonic, std::strlen(op->mnemonic)));
+            names.push_back(op->mnemonic); opcodes.push_back(op);
+        }
+        //Group keys into buckets, and place the largest buckets first (they are the hardest to fit).
+        std::vector<std::vector<mnemonic_t>> buckets(BUCKETS);
+        for(mnemonic_t id = 0; id < keys.size(); id++) buckets[bucketOf(keys[id])].push_back(id);
+        std::vector<unsigned> order;
+        for(unsigned b = 0; b < BUCKETS; b++) order.push_back(b);
+        std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {return buckets[a].size() > buckets[b].size();});
+        for(unsigned s = 0; s < SLOTS; s++) {slotKey[s] = 0u; slotId[s] = NO_MNEMONIC;}
+        for(unsigned b = 0; b < BUCKETS; b++) displacement[b] = 0u;
+        for(unsigned b : order) {
+            const std::vector<mnemonic_t> &bucket = buckets[b];
+            if(bucket.empty()) break;
+            for(data16_calc_t d = 0; d <= 0xFFFFu; d++) {
+                //Check that every key of this bucket lands in a distinct empty slot.
+                bool fits = true;
+                for(size_t k = 0; k < bucket.size() && fits; k++) {
+                    const unsigned s = slotOf(keys[bucket[k]], (data16_t)d);
+                    if(slotKey[s] != 0u) fits = false;
+                    for(size_t l = 0; l < k && fits; l++) if(slotOf(keys[bucket[l]], (data16_t)d) == s) fits = false;
+                }
+                if(!fits) continue;
+                displacement[b] = (data16_t)d;
+                for(mnemonic_t id : bucket) {const unsigned s = slotOf(keys[id], (data16_t)d); slotKey[s] = keys[id]; slotId[s] = id;}
+                break;
+            }
+        }
+    }
+    mnemonic_t find(const char *s, size_t length) const {
+        const uint_fast64_t key = packMnemonic(s, length);
+        if(key == 0u) return NO_MNEMONIC;
+        const unsigned slot = slotOf(key, displacement[bucketOf(key)]);
+        return slotKey[slot] == key ? slotId[slot] : NO_MNEMONIC;
     }
-    std::map<const char *, const opcode *, CaseInsensitive>::iterator node = nameMap.find(name);
-    return node != nameMap.end() ? node->second : nullptr;
+};
+///The mnemonic table, built on first use. (Function-local statics are initialized thread-safely.)
+static const MnemonicTable &mnemonicTable() {
+    static const MnemonicTable table;
+    return table;
 }
 
-const opcode ORG        ("ORG");
-const opcode DATA       ("DATA");
+mnemonic_t findMnemonic(const char *s, size_t length) {return mnemonicTable().find(s, length);}
+mnemonic_t mnemonicCount() {return (mnemonic_t)mnemonicTable().names.size();}
+const char *mnemonicName(mnemonic_t id) {return id < mnemonicCount() ? mnemonicTable().names[id] : nullptr;}
+bool isPseudocodeMnemonic(mnemonic_t id) {return id < mnemonicCount() && id >= mnemonicTable().firstPseudocode;}
+const opcode *getOpcode(mnemonic_t id) {return id < mnemonicCount() ? mnemonicTable().opcodes[id] : nullptr;}
 
-bool isPseudocode(const char * const name) {
-    static std::set<const char *, CaseInsensitive> pseudoSet;
-    if(pseudoSet.empty()) {pseudoSet.insert("ORG"); pseudoSet.insert("DATA");}
-    return pseudoSet.find(name) != pseudoSet.end();
+bool isOpcode(const char * const name) {
+    const mnemonic_t id = findMnemonic(name, std::strlen(name));
+    return id != NO_MNEMONIC && !isPseudocodeMnemonic(id);
+}
+const opcode *getOpcode(const char * const name) {
+    const mnemonic_t id = findMnemonic(name, std::strlen(name));
+    return isPseudocodeMnemonic(id) ? nullptr : getOpcode(id);
 }
+bool isPseudocode(const char * const name) {return isPseudocodeMnemonic(findMnemonic(name, std::strlen(name)));}
 const opcode *getPseudocode(const char * const name) {
-    static std::map<const char *, const opcode *, CaseInsensitive> pseudoMap;
-    if(pseudoMap.empty()) {pseudoMap.insert({"ORG", &ORG}); pseudoMap.insert({"DATA", &DATA});}
-    std::map<const char *, const opcode *, CaseInsensitive>::iterator node = pseudoMap.find(name);
-    return node != pseudoMap.end() ? node->second : nullptr;
+    const mnemonic_t id = findMnemonic(name, std::strlen(name));
+    return isPseudocodeMnemonic(id) ? getOpcode(id) : nullptr;
 }
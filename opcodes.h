@@ -560,11 +560,61 @@ extern const opcode CPI;
 ///Restart 7 (RST 7); hex machine code 0xFF.
 extern const opcode RST_7;
 
-//As of right now; two opcodes are supported.
+//Pseudocodes (assembler directives).
 ///Indicates the address offset from which to put instructions
 extern const opcode ORG;
 ///Lists data bytes to be put without translation into the processor memory.
 extern const opcode DATA;
+///Defines a constant symbol ("NAME EQU value"); it cannot be redefined.
+extern const opcode EQU;
+///Defines a variable symbol ("NAME SET value"); it can be redefined by another SET.
+extern const opcode SET;
+///Defines bytes (numbers or strings) at the current address.
+extern const opcode DB;
+///Defines words (stored low byte first) at the current address.
+extern const opcode DW;
+///Reserves a block of bytes at the current address without writing to it.
+extern const opcode DS;
+///Copies the bytes of a binary file to the current address ("INCBIN \"file\"").
+extern const opcode INCBIN;
+//Preprocessor directives (handled before translation; see assembler.h/Preprocessor).
+///Starts a macro definition ("NAME MACRO param, param, ..."), ended by ENDM.
+extern const opcode MACRO;
+///Ends a MACRO, REPT or IRP block.
+extern const opcode ENDM;
+///Repeats the lines up to ENDM a number of times ("REPT count").
+extern const opcode REPT;
+///Repeats the lines up to ENDM once for each value of a list ("IRP param, <value, value, ...>").
+extern const opcode IRP;
+///Assembles the following lines only if the expression is not 0 ("IF expression").
+extern const opcode IF;
+///Switches to the other branch of an IF.
+extern const opcode ELSE;
+///Ends an IF.
+extern const opcode ENDIF;
+///Reads the lines of another source file in place of this line ("INCLUDE \"file\"").
+extern const opcode INCLUDE;
+
+///Dense identifier for a mnemonic (opcode or pseudocode). Identifiers run from 0 to mnemonicCount()-1 so they can index
+///plain arrays.
+typedef unsigned mnemonic_t;
+///Returned by findMnemonic() when the text is not a mnemonic.
+#define NO_MNEMONIC ((mnemonic_t)~0u)
+///No mnemonic (opcode or pseudocode) is longer than this many characters.
+#define MNEMONIC_MAX_LENGTH 8u
+
+///Look up a mnemonic by its characters, ignoring case. s need not be null-terminated. Uses a perfect hash over the upper-cased
+///mnemonic set, so a lookup is one hash, one probe and one integer comparison. Returns NO_MNEMONIC if not found.
+extern mnemonic_t findMnemonic(const char *s, size_t length);
+///Number of mnemonics (opcodes and pseudocodes) known.
+extern mnemonic_t mnemonicCount();
+///Upper-case text of a mnemonic.
+extern const char *mnemonicName(mnemonic_t id);
+///Is the mnemonic a pseudocode (ORG, DATA etc)?
+extern bool isPseudocodeMnemonic(mnemonic_t id);
+///Get the opcode (or pseudocode) identified by the mnemonic alone (example "NOP" or "JMP"), or nullptr if operands are needed
+///to choose one (example "MOV").
+extern const opcode *getOpcode(mnemonic_t id);
 
 ///Checks if the string refers to a valid pseudocode name.
 extern bool isPseudocode(const char * const name);
@@ -577,6 +627,13 @@ extern bool isOpcode(const char * const name);
 extern const opcode *getOpcode(const char * const name);
 ///Map opcodes by bytecode.
 extern const opcode *opcodesByCode[256];
+///Number of T-states (clock cycles) taken by each opcode, indexed by bytecode. For conditional returns, jumps and calls this is
+///the count when the condition is NOT met; add TSTATES_EXTRA_ON_CONDITION_MET() when it is.
+extern const data8_t tStatesByCode[256];
+///Extra T-states taken by a conditional return (Rcc), jump (Jcc) or call (Ccc) when its condition is met. 0 for every other
+///opcode.
+#define TSTATES_EXTRA_ON_CONDITION_MET(code) \
+    (((code) & 0xC7u) == 0xC0u ? 6u : ((code) & 0xC7u) == 0xC2u ? 3u : ((code) & 0xC7u) == 0xC4u ? 9u : 0u)
 
 ///Call this in main() so that Qt knows about these types.
 #define OPCODES_H_registerHeaderMetaTypes() {\
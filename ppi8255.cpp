@@ -0,0 +1,61 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "ppi8255.h"
+
+PPI8255::PPI8255() {
+    inputs[PORT_A] = inputs[PORT_B] = inputs[PORT_C] = 0u;
+    reset();
+}
+
+data8_t PPI8255::outputMask(unsigned port) const {
+    switch(port) {
+    case PORT_A: return (control & 0x10u) ? 0x00u : 0xFFu;
+    case PORT_B: return (control & 0x02u) ? 0x00u : 0xFFu;
+    default: return ((control & 0x08u) ? 0x00u : 0xF0u) | ((control & 0x01u) ? 0x00u : 0x0Fu);
+    }
+}
+data8_t PPI8255::getPins(unsigned port) const {
+    if(port >= 3u) return 0u;
+    data8_t mask = outputMask(port);
+    return (outputs[port] & mask) | (inputs[port] & ~mask & 0xFFu);
+}
+
+data8_t PPI8255::read(memaddr_t reg, cycles_t) {
+    if(reg >= 3u) return 0xFFu; //the control register cannot be read
+    return getPins(reg);
+}
+void PPI8255::write(memaddr_t reg, data8_t data, cycles_t) {
+    if(reg < 3u) {outputs[reg] = data; outputWritten(reg); return;}
+    if(data & 0x80u) { //mode set; all output latches are cleared
+        control = data;
+        for(unsigned i = 0; i < 3u; i++) {outputs[i] = 0u; outputWritten(i);}
+    }
+    else { //port C bit set/reset
+        data8_t bit = 1u << ((data >> 1) & 7u);
+        if(data & 1u) outputs[PORT_C] |= bit; else outputs[PORT_C] &= ~bit & 0xFFu;
+        outputWritten(PORT_C);
+    }
+}
+void PPI8255::reset() {
+    control = 0x9Bu; //mode 0, all ports input
+    outputs[PORT_A] = outputs[PORT_B] = outputs[PORT_C] = 0u;
+}
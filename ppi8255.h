@@ -0,0 +1,80 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef PPI8255_H
+#define PPI8255_H
+
+#include <functional>
+#include "iodevice.h"
+
+///Models an 8255 programmable peripheral interface (ports A, B and C and the control register at register offsets 0 to 3).
+///Mode 0 (basic I/O with any combination of input/output groups) and the port C bit set/reset command are supported. The
+///handshake modes (1 and 2 for group A, 1 for group B) are accepted but behave like mode 0: the ports keep their programmed
+///directions and no port C handshake lines are generated.
+///
+///The external side is plain data: setInput() drives the pins of input ports, getPins()/getOutput() read what the program has
+///output, and an optional handler is called (on the processor's thread) whenever an output latch is written.
+class PPI8255 : public IODevice {
+public:
+    ///Indices of the ports (same as their register offsets).
+    enum Port : unsigned {
+        ///Port A
+        PORT_A = 0u,
+        ///Port B
+        PORT_B,
+        ///Port C
+        PORT_C
+    };
+private:
+    ///Last mode set control word.
+    data8_t control;
+    ///Output latches of ports A, B and C.
+    data8_t outputs[3];
+    ///Levels driven onto the pins of ports A, B and C from outside.
+    data8_t inputs[3];
+    ///Called with the port index and the new latch value whenever an output latch is written.
+    std::function<void(unsigned, data8_t)> outputHandler;
+
+    ///Bits of port which are currently outputs.
+    data8_t outputMask(unsigned port) const;
+    ///Notify the output handler (if any) that the latch of port was written.
+    void outputWritten(unsigned port) {if(outputHandler) outputHandler(port, outputs[port]);}
+public:
+    ///Constructor. Initially every port is an input (as after RESET).
+    PPI8255();
+
+    data8_t read(memaddr_t reg, cycles_t now); //override
+    void write(memaddr_t reg, data8_t data, cycles_t now); //override
+    void reset(); //override
+
+    ///Drive the pins of port from outside. Only bits programmed as inputs are visible to the program.
+    void setInput(unsigned port, data8_t value) {if(port < 3u) inputs[port] = value;}
+    ///Get the output latch of port.
+    data8_t getOutput(unsigned port) const {return port < 3u ? outputs[port] : 0u;}
+    ///Get the levels on the pins of port: the output latch for output bits and the external inputs for the others.
+    data8_t getPins(unsigned port) const;
+    ///Get the last mode set control word.
+    data8_t getControlWord() const {return control;}
+    ///Set a function to be called (with the port index and the new latch value) whenever an output latch is written.
+    void setOutputHandler(const std::function<void(unsigned, data8_t)> &handler) {outputHandler = handler;}
+};
+
+#endif // PPI8255_H
@@ -27,18 +27,25 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     : QObject(parent),
       microprograms(new std::function<void()>[256]),
       memory(new data8_t[MEMORY_SIZE]),
-      io(new data8_t[IO_PORT_SIZE]){
+      io(new data8_t[IO_PORT_SIZE]),
+      ioDevices(new IOPortMapping[IO_PORT_SIZE]),
+      pages(new MemoryPage[MEMORY_PAGE_COUNT]){
     const std::function<void()> UNUSED = [&](){
-        unused = 1u; emit unusedInstruction(memory[pc]);
+        unused = 1u; emit unusedInstruction(memory[pc & 0xFFFFu]); //the opcode already fetched; no second bus access
         //pc++; pc &= 0xFFFFu; emit programCounterChanged(); This is an error
     };
     std::memset((void *)memory, 0, sizeof(data8_t) * MEMORY_SIZE);
     std::memset((void *)io, 0, sizeof(data8_t) * IO_PORT_SIZE);
+    for(unsigned i = 0; i < IO_PORT_SIZE; i++) {ioDevices[i].device = nullptr; ioDevices[i].first = i;}
     intrVec = 0;
     pc = sp = 0u;
     a = b = c = d = e = h = l = 0u; f = 0u;
     ie = intr = inta = trap = rst7_5 = rst6_5 = rst5_5 = sod = sid = halt = unused = trap_lowToHigh = 0u;
     m5_5 = m6_5 = m7_5 = 1u; //Initial state is these external interrupts are masked.
+    cycles = busCycle = 0u;
+    serialDevice = nullptr;
+    romFault = 0u; trapROMWrites = false; romFaultAddress = 0u;
+    resetMemoryMap();
 
     //Microprograms (or, what to do on each opcode) is coded here.
 
@@ -46,13 +53,13 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[NOP]      = [&](){pc++; pc &= 0xFFFFu; emit programCounterChanged();};
     //LXI B, word (load register pair immediate BC); hex machine code 0x01.
     microprograms[LXI_B]    = [&](){
-        c = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerCChanged();
-        b = memory[(pc + 2u) & 0xFFFFu] & 0xFFu; emit registerBChanged();
+        c = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerCChanged();
+        b = readMemory((pc + 2u) & 0xFFFFu) & 0xFFu; emit registerBChanged();
         pc += 3; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //STAX B (store accumulator indirect BC); hex machine code 0x02.
     microprograms[STAX_B]   = [&](){
-        memory[PACK(b, c)] = a & 0xFFu; emit memoryBlockUpdated(PACK(b, c), 1u);
+        writeMemory(PACK(b, c), a & 0xFFu); emit memoryBlockUpdated(PACK(b, c), 1u);
         if(PACK(b, c) == PACK(h, l)) emit MChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -86,7 +93,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI B, byte (move immediate to B); hex machine code 0x06.
     microprograms[MVI_B]    = [&](){
-        b = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerBChanged();
+        b = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerBChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //RLC (rotate left); hex machine code 0x07.
@@ -106,7 +113,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //LDAX B (load accumulator indirect BC); hex machine code 0x0A.
     microprograms[LDAX_B]   = [&](){
-        a = memory[PACK(b, c)] & 0xFFu; emit accumulatorChanged();
+        a = readMemory(PACK(b, c)) & 0xFFu; emit accumulatorChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //DCX B (decrement register pair BC); hex machine code 0x0B.
@@ -139,7 +146,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI C, byte (move immediate to C); hex machine code 0x0E.
     microprograms[MVI_C]    = [&](){
-        c = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerCChanged();
+        c = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerCChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //RRC (rotate right); hex machine code 0x0F.
@@ -152,13 +159,13 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[0x10u]    = UNUSED;
     //LXI D, word (load register pair immediate DE); hex machine code 0x11.
     microprograms[LXI_D]    = [&](){
-        e = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerEChanged();
-        d = memory[(pc + 2u) & 0xFFFFu] & 0xFFu; emit registerDChanged();
+        e = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerEChanged();
+        d = readMemory((pc + 2u) & 0xFFFFu) & 0xFFu; emit registerDChanged();
         pc += 3; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //STAX D (store accumulator indirect DE); hex machine code 0x12.
     microprograms[STAX_D]   = [&](){
-        memory[PACK(d, e)] = a & 0xFFu; emit memoryBlockUpdated(PACK(d, e), 1u);
+        writeMemory(PACK(d, e), a & 0xFFu); emit memoryBlockUpdated(PACK(d, e), 1u);
         if(PACK(d, e) == PACK(h, l)) emit MChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -192,7 +199,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI D, byte (move immediate to D); hex machine code 0x16.
     microprograms[MVI_D]    = [&](){
-        d = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerDChanged();
+        d = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerDChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //RAL (rotate left through carry); hex machine code 0x17.
@@ -213,7 +220,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //LDAX D (load accumulator indirect DE); hex machine code 0x1A.
     microprograms[LDAX_D]   = [&](){
-        a = memory[PACK(d, e)] & 0xFFu; emit accumulatorChanged();
+        a = readMemory(PACK(d, e)) & 0xFFu; emit accumulatorChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //DCX D (decrement register pair DE); hex machine code 0x1B.
@@ -246,7 +253,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI E, byte (move immediate to E); hex machine code 0x1E.
     microprograms[MVI_E]    = [&](){
-        e = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerEChanged();
+        e = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerEChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //RAR (rotate right through carry); hex machine code 0x1F.
@@ -259,6 +266,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //RIM (read interrupt masks); hex machine code 0x20.
     microprograms[RIM]      = [&](){
+        if(serialDevice) sid = serialDevice->serialInputLevel(cycles + 4u) ? 1u : 0u;
         a = ((sid << 7) | (rst7_5 << 6) | (rst6_5 << 5) | (rst5_5 << 4) | (ie << 3) |
              (m7_5 << 2) | (m6_5 << 1) | m5_5) & 0xFFu;
         emit accumulatorChanged();
@@ -266,15 +274,15 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //LXI H, word (load register pair immediate HL); hex machine code 0x21.
     microprograms[LXI_H]    = [&](){
-        l = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerLChanged();
-        h = memory[(pc + 2u) & 0xFFFFu] & 0xFFu; emit registerHChanged();
+        l = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerLChanged();
+        h = readMemory((pc + 2u) & 0xFFFFu) & 0xFFu; emit registerHChanged();
         emit MChanged();
         pc += 3; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //SHLD word (store HL direct); hex machine code 0x22.
     microprograms[SHLD]   = [&](){
-        memaddr_t offset = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
-        memory[offset] = l & 0xFFu; memory[(offset + 1) & 0xFFFFu] = h & 0xFFu;
+        memaddr_t offset = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
+        writeMemory(offset, l & 0xFFu); writeMemory((offset + 1) & 0xFFFFu, h & 0xFFu);
         emit memoryBlockUpdated(offset, 2u);
         if(offset == PACK(h, l)) emit MChanged();
         pc+=3; pc &= 0xFFFFu; emit programCounterChanged();
@@ -309,7 +317,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI H, byte (move immediate to H); hex machine code 0x26.
     microprograms[MVI_H]    = [&](){
-        h = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerHChanged(); emit MChanged();
+        h = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerHChanged(); emit MChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //DAA (decimal adjust accumulator); hex machine code 0x27.
@@ -336,8 +344,8 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //LHLD word (load HL direct); hex machine code 0x2A.
     microprograms[LHLD]   = [&](){
-        memaddr_t offset = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
-        l = memory[offset] & 0xFFu; h = memory[(offset + 1) & 0xFFFFu] & 0xFFu;
+        memaddr_t offset = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
+        l = readMemory(offset) & 0xFFu; h = readMemory((offset + 1) & 0xFFFFu) & 0xFFu;
         emit registerHChanged(); emit registerLChanged(); emit MChanged();
         pc+=3; pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -371,7 +379,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI L, byte (move immediate to L); hex machine code 0x2E.
     microprograms[MVI_L]    = [&](){
-        l = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit registerLChanged(); emit MChanged();
+        l = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit registerLChanged(); emit MChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CMA (complement accumulator); hex machine code 0x2F.
@@ -387,19 +395,23 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
             m7_5 = (a >> 2) & 1u; emit maskRestart7_5Changed();
         }
         if(a & 0x10u) {rst7_5 = 0u; emit restart7_5RequestStatusChanged();}
-        if(a & 0x40u) {sod = (a >> 7) & 1u; emit serialOutput();}
+        if(a & 0x40u) {
+            sod = (a >> 7) & 1u;
+            if(serialDevice) serialDevice->serialOutputChanged(sod, cycles + 4u); //no signal per bit
+            else emit serialOutput();
+        }
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //LXI SP, word (load register pair immediate SP); hex machine code 0x31.
     microprograms[LXI_SP]   = [&](){
-        sp = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+        sp = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         emit stackPointerChanged();
         pc+=3; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //STA word (store accumulator direct); hex machine code 0x32.
     microprograms[STA]      = [&](){
-        memaddr_t offset = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
-        memory[offset] = a & 0xFFu; emit memoryBlockUpdated(offset, 1u);
+        memaddr_t offset = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
+        writeMemory(offset, a & 0xFFu); emit memoryBlockUpdated(offset, 1u);
         if(offset == PACK(h, l)) emit MChanged();
         pc+=3; pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -410,29 +422,31 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //INR M (increment memory); hex machine code 0x34.
     microprograms[INR_M]    = [&](){
-        data8_calc_t temp = memory[PACK(h, l)]+1u; temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((memory[PACK(h, l)] & 0x0Fu) + 1u) > 0x0Fu); temp &= 0xFFu;
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu; //read once; M may be a device register
+        data8_calc_t temp = value+1u; temp &= 0xFFu;
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((value & 0x0Fu) + 1u) > 0x0Fu); temp &= 0xFFu;
         SET_SPEC_FLAG(f, ZERO_FLAG, temp == 0u);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
         emit flagsChanged();
-        memory[PACK(h, l)] = temp & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), temp & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //DCR M (decrement memory); hex machine code 0x35.
     microprograms[DCR_M]    = [&](){
-        data8_calc_t temp = memory[PACK(h, l)]+NEGATE8(1u); temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, (memory[PACK(h, l)] & 0x0Fu) < 1u); temp &= 0xFFu;
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu;
+        data8_calc_t temp = value+NEGATE8(1u); temp &= 0xFFu;
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, (value & 0x0Fu) < 1u); temp &= 0xFFu;
         SET_SPEC_FLAG(f, ZERO_FLAG, temp == 0u);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
         emit flagsChanged();
-        memory[PACK(h, l)] = temp & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), temp & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MVI M, byte (move immediate to memory); hex machine code 0x36.
     microprograms[MVI_M]    = [&](){
-        memory[PACK(h, l)] = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), readMemory((pc + 1u) & 0xFFFFu) & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //STC (set carry); hex machine code 0x37.
@@ -450,8 +464,8 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //LDA word (load accumulator direct); hex machine code 0x3A.
     microprograms[LDA]      = [&](){
-        memaddr_t offset = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
-        a = memory[offset] & 0xFFu; emit accumulatorChanged();
+        memaddr_t offset = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
+        a = readMemory(offset) & 0xFFu; emit accumulatorChanged();
         pc+=3; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //DCX SP (decrement register pair SP); hex machine code 0x3B.
@@ -483,7 +497,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MVI A, byte (move immediate to accumulator); hex machine code 0x3E.
     microprograms[MVI_A]    = [&](){
-        a = memory[(pc + 1u) & 0xFFFFu] & 0xFFu; emit accumulatorChanged();
+        a = readMemory((pc + 1u) & 0xFFFFu) & 0xFFu; emit accumulatorChanged();
         pc += 2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CMC (complement carry); hex machine code 0x3F.
@@ -520,7 +534,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV B, M (move memory to B); hex machine code 0x46.
     microprograms[MOV_B_M]  = [&](){
-        b = memory[PACK(h, l)] & 0xFFu; emit registerBChanged();
+        b = readMemory(PACK(h, l)) & 0xFFu; emit registerBChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV B, A (move accumulator to B); hex machine code 0x47.
@@ -557,7 +571,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV C, M (move memory to C); hex machine code 0x4E.
     microprograms[MOV_C_M]  = [&](){
-        c = memory[PACK(h, l)] & 0xFFu; emit registerCChanged();
+        c = readMemory(PACK(h, l)) & 0xFFu; emit registerCChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV C, A (move accumulator to C); hex machine code 0x4F.
@@ -594,7 +608,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV D, M (move memory to D); hex machine code 0x56.
     microprograms[MOV_D_M]  = [&](){
-        d = memory[PACK(h, l)] & 0xFFu; emit registerDChanged();
+        d = readMemory(PACK(h, l)) & 0xFFu; emit registerDChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV D, A (move accumulator to D); hex machine code 0x57.
@@ -631,7 +645,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV E, M (move memory to E); hex machine code 0x5E.
     microprograms[MOV_E_M]  = [&](){
-        e = memory[PACK(h, l)] & 0xFFu; emit registerEChanged();
+        e = readMemory(PACK(h, l)) & 0xFFu; emit registerEChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV E, A (move accumulator to E); hex machine code 0x5F.
@@ -668,7 +682,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV H, M (move memory to H); hex machine code 0x66.
     microprograms[MOV_H_M]  = [&](){
-        h = memory[PACK(h, l)] & 0xFFu; emit registerHChanged(); emit MChanged();
+        h = readMemory(PACK(h, l)) & 0xFFu; emit registerHChanged(); emit MChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV H, A (move accumulator to H); hex machine code 0x67.
@@ -705,7 +719,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[MOV_L_L]  = microprograms[NOP]; //Why does this instruction exist??
     //MOV L, M (move memory to L); hex machine code 0x6E.
     microprograms[MOV_L_M]  = [&](){
-        l = memory[PACK(h, l)] & 0xFFu; emit registerLChanged(); emit MChanged();
+        l = readMemory(PACK(h, l)) & 0xFFu; emit registerLChanged(); emit MChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV L, A (move accumulator to L); hex machine code 0x6F.
@@ -715,32 +729,32 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV M, B (move register B to memory); hex machine code 0x70.
     microprograms[MOV_M_B]  = [&](){
-        memory[PACK(h, l)] = b & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), b & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV M, C (move register C to memory); hex machine code 0x71.
     microprograms[MOV_M_C]  = [&](){
-        memory[PACK(h, l)] = c & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), c & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV M, D (move register D to memory); hex machine code 0x72.
     microprograms[MOV_M_D]  = [&](){
-        memory[PACK(h, l)] = d & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), d & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV M, E (move register E to memory); hex machine code 0x73.
     microprograms[MOV_M_E]  = [&](){
-        memory[PACK(h, l)] = e & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), e & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV M, H (move register H to memory); hex machine code 0x74.
     microprograms[MOV_M_H]  = [&](){
-        memory[PACK(h, l)] = h & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), h & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV M, L (move register L to memory); hex machine code 0x75.
     microprograms[MOV_M_L]  = [&](){
-        memory[PACK(h, l)] = l & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), l & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //HLT (halt); hex machine code 0x76.
@@ -750,7 +764,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV M, A (move accumulator to memory); hex machine code 0x77.
     microprograms[MOV_M_A]  = [&](){
-        memory[PACK(h, l)] = a & 0xFFu; emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
+        writeMemory(PACK(h, l), a & 0xFFu); emit MChanged(); emit memoryBlockUpdated(PACK(h, l), 1u);
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV A, B (move register B to accumulator); hex machine code 0x78.
@@ -785,7 +799,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //MOV A, M (move register B to accumulator); hex machine code 0x7E.
     microprograms[MOV_A_M]  = [&](){
-        a = memory[PACK(h, l)] & 0xFFu; emit accumulatorChanged();
+        a = readMemory(PACK(h, l)) & 0xFFu; emit accumulatorChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //MOV A, A (move accumulator to accumulator); hex machine code 0x7F.
@@ -864,9 +878,10 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //ADD M (add memory to accumulator); hex machine code 0x86.
     microprograms[ADD_M]    = [&](){
-        data8_calc_t temp = a + memory[PACK(h, l)];
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu;
+        data8_calc_t temp = a + value;
         SET_SPEC_FLAG(f, CARRY_FLAG, temp > 0xFFu); temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (memory[PACK(h, l)] & 0xFu)) > 0xFu);
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (value & 0xFu)) > 0xFu);
         SET_SPEC_FLAG(f, ZERO_FLAG, temp == 0u);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
@@ -966,10 +981,11 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //ADC M (add memory to accumulator with carry); hex machine code 0x8E.
     microprograms[ADC_M]    = [&](){
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu;
         data8_t cy= CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u;
-        data8_calc_t temp = a + memory[PACK(h, l)] + cy;
+        data8_calc_t temp = a + value + cy;
         SET_SPEC_FLAG(f, CARRY_FLAG, temp > 0xFFu); temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (memory[PACK(h, l)] & 0xFu) + cy) > 0xFu);
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (value & 0xFu) + cy) > 0xFu);
         SET_SPEC_FLAG(f, ZERO_FLAG, temp == 0u);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
@@ -1064,10 +1080,11 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //SUB M (subtract memory from accumulator); hex machine code 0x96.
     microprograms[SUB_M]    = [&](){
-        data8_calc_t temp = a + NEGATE8(memory[PACK(h, l)]);
-        SET_SPEC_FLAG(f, CARRY_FLAG, a < memory[PACK(h, l)]); temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (memory[PACK(h, l)] & 0xFu)));
-        SET_SPEC_FLAG(f, ZERO_FLAG, a == memory[PACK(h, l)]);
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu;
+        data8_calc_t temp = a + NEGATE8(value);
+        SET_SPEC_FLAG(f, CARRY_FLAG, a < value); temp &= 0xFFu;
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (value & 0xFu)));
+        SET_SPEC_FLAG(f, ZERO_FLAG, a == value);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
         emit flagsChanged();
@@ -1165,7 +1182,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //SBB M (subtract memory from accumulator with borrow); hex machine code 0x9E.
     microprograms[SBB_M]    = [&](){
-        data8_t rhs = (memory[PACK(h, l)] + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u)) & 0xFF;
+        data8_t rhs = (readMemory(PACK(h, l)) + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u)) & 0xFF;
         data8_calc_t temp = a + NEGATE8(rhs);
         SET_SPEC_FLAG(f, CARRY_FLAG, a < rhs); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (rhs & 0xFu)));
@@ -1249,7 +1266,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //ANA M (AND memory with accumulator); hex machine code 0xA6.
     microprograms[ANA_M]    = [&](){
-        a = a & memory[PACK(h, l)] & 0xFFu; emit accumulatorChanged();
+        a = a & readMemory(PACK(h, l)) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         SET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 1
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1328,7 +1345,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //XRA M (XOR memory with accumulator); hex machine code 0xAE.
     microprograms[XRA_M]    = [&](){
-        a = (a ^ memory[PACK(h, l)]) & 0xFFu; emit accumulatorChanged();
+        a = (a ^ readMemory(PACK(h, l))) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         UNSET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 0
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1409,7 +1426,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //ORA M (OR memory with accumulator); hex machine code 0xB6.
     microprograms[ORA_M]    = [&](){
-        a = (a | memory[PACK(h, l)]) & 0xFFu; emit accumulatorChanged();
+        a = (a | readMemory(PACK(h, l))) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         UNSET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 0
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1494,10 +1511,11 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     };
     //CMP M (compare memory against accumulator); hex machine code 0xBE.
     microprograms[CMP_M]    = [&](){
-        data8_calc_t temp = a + NEGATE8(memory[PACK(h, l)]);
-        SET_SPEC_FLAG(f, CARRY_FLAG, a < memory[PACK(h, l)]); temp &= 0xFFu;
-        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (memory[PACK(h, l)] & 0xFu)));
-        SET_SPEC_FLAG(f, ZERO_FLAG, a == memory[PACK(h, l)]);
+        const data8_t value = readMemory(PACK(h, l)) & 0xFFu;
+        data8_calc_t temp = a + NEGATE8(value);
+        SET_SPEC_FLAG(f, CARRY_FLAG, a < value); temp &= 0xFFu;
+        SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (value & 0xFu)));
+        SET_SPEC_FLAG(f, ZERO_FLAG, a == value);
         SET_SPEC_FLAG(f, SIGN_FLAG, (temp & 0x80u) == 0x80u);
         SET_SPEC_FLAG(f, PARITY_FLAG, PARITY_LOOKUP[temp]);
         emit flagsChanged();
@@ -1516,55 +1534,55 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RNZ (return on nonzero); hex machine code 0xC0.
     microprograms[RNZ]      = [&](){
         if(!CHECK_FLAG(f, ZERO_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //POP B (pop BC from stack); hex machine code 0xC1.
     microprograms[POP_B]    = [&](){
-        c = memory[sp & 0xFFFFu]; sp++; emit registerCChanged();
-        b = memory[sp & 0xFFFFu]; sp++; emit registerBChanged();
+        c = readMemory(sp & 0xFFFFu); sp++; emit registerCChanged();
+        b = readMemory(sp & 0xFFFFu); sp++; emit registerBChanged();
         sp &= 0xFFFFu; emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JNZ address (jump on nonzero); hex machine code 0xC2.
     microprograms[JNZ]      = [&](){
         if(!CHECK_FLAG(f, ZERO_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JMP address (jump); hex machine code 0xC3.
     microprograms[JMP]      = [&](){
-        pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+        pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CNZ address (Call on nonzero); hex machine code 0xC4.
     microprograms[CNZ]      = [&](){
         if(!CHECK_FLAG(f, ZERO_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //PUSH B (push BC on stack); hex machine code 0xC5.
     microprograms[PUSH_B]   = [&](){
-        sp--; sp &= 0xFFFFu; memory[sp] = b & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, b & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = c & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, c & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //ADI byte (add immediate to accumulator); hex machine code 0xC6.
     microprograms[ADI]      = [&](){
-        data8_t rhs = memory[(pc + 1) & 0xFFFFu] & 0xFFu;
+        data8_t rhs = readMemory((pc + 1) & 0xFFFFu) & 0xFFu;
         data8_calc_t temp = a + rhs;
         SET_SPEC_FLAG(f, CARRY_FLAG, temp > 0xFFu); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (rhs & 0xFu)) > 0xFu);
@@ -1578,9 +1596,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 0 (restart 0); hex machine code 0xC7.
     microprograms[RST_0]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 0u; emit programCounterChanged();
@@ -1588,21 +1606,21 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RZ (return on zero); hex machine code 0xC8.
     microprograms[RZ]       = [&](){
         if(CHECK_FLAG(f, ZERO_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //RET (return); hex machine code 0xC9.
     microprograms[RET]      = [&](){
-        pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+        pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
         sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JZ address (jump on zero); hex machine code 0xCA.
     microprograms[JZ]       = [&](){
         if(CHECK_FLAG(f, ZERO_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -1611,29 +1629,29 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[CZ]      = [&](){
         if(CHECK_FLAG(f, ZERO_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CALL address (call); hex machine code 0xCD.
     microprograms[CALL]     = [&](){
         pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-        pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+        pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //ACI byte (add immediate to accumulator); hex machine code 0xCE.
     microprograms[ACI]      = [&](){
-        data8_t rhs = (memory[(pc + 1) & 0xFFFFu] & 0xFFu) + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u);
+        data8_t rhs = (readMemory((pc + 1) & 0xFFFFu) & 0xFFu) + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u);
         data8_calc_t temp = a + rhs;
         SET_SPEC_FLAG(f, CARRY_FLAG, temp > 0xFFu); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) + (rhs & 0xFu)) > 0xFu);
@@ -1647,9 +1665,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 1 (restart 1); hex machine code 0xCF.
     microprograms[RST_1]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 8u; emit programCounterChanged();
@@ -1657,56 +1675,58 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RNC (return on NOT carry); hex machine code 0xD0.
     microprograms[RNC]       = [&](){
         if(!CHECK_FLAG(f, CARRY_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //POP D (pop DE from stack); hex machine code 0xD1.
     microprograms[POP_D]    = [&](){
-        e = memory[sp & 0xFFFFu]; sp++; emit registerEChanged();
-        d = memory[sp & 0xFFFFu]; sp++; emit registerDChanged();
+        e = readMemory(sp & 0xFFFFu); sp++; emit registerEChanged();
+        d = readMemory(sp & 0xFFFFu); sp++; emit registerDChanged();
         sp &= 0xFFFFu; emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JNC address (jump on NOT carry); hex machine code 0xD2.
     microprograms[JNC]      = [&](){
         if(!CHECK_FLAG(f, CARRY_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //OUT port (output); hex machine code 0xD3.
     microprograms[OUT]      = [&](){
-        ioaddr_t port = memory[(pc + 1) & 0xFFFFu] & 0xFFu;
-        io[port] = a & 0xFFu; emit ioPortUpdated(port);
+        ioaddr_t port = readMemory((pc + 1) & 0xFFFFu) & 0xFFu;
+        if(ioDevices[port].device) //I/O cycle is the last machine cycle; the data is on the bus at T-state 10
+            ioDevices[port].device->write((port - ioDevices[port].first) & 0xFFu, a & 0xFFu, cycles + 10u);
+        else {io[port] = a & 0xFFu; emit ioPortUpdated(port);}
         pc+=2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CNC address (Call on NOT carry); hex machine code 0xD4.
     microprograms[CNC]      = [&](){
         if(!CHECK_FLAG(f, CARRY_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //PUSH D (push DE on stack); hex machine code 0xD5.
     microprograms[PUSH_D]   = [&](){
-        sp--; sp &= 0xFFFFu; memory[sp] = d & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, d & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = e & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, e & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //SUI byte (subtract immediate from accumulator); hex machine code 0xD6.
     microprograms[SUI]      = [&](){
-        data8_t rhs = memory[(pc + 1) & 0xFFFFu] & 0xFFu;
+        data8_t rhs = readMemory((pc + 1) & 0xFFFFu) & 0xFFu;
         data8_calc_t temp = a + NEGATE8(rhs);
         SET_SPEC_FLAG(f, CARRY_FLAG, a < rhs); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (rhs & 0xFu)));
@@ -1720,9 +1740,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 2 (restart 2); hex machine code 0xD7.
     microprograms[RST_2]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 16u; emit programCounterChanged();
@@ -1730,7 +1750,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RC (return on carry); hex machine code 0xD8.
     microprograms[RC]       = [&](){
         if(CHECK_FLAG(f, CARRY_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
@@ -1739,33 +1759,35 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //JC address (jump on carry); hex machine code 0xDA.
     microprograms[JC]       = [&](){
         if(CHECK_FLAG(f, CARRY_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //Input (IN); hex machine code 0xDB.
     microprograms[IN]       = [&](){
-        ioaddr_t port = memory[(pc + 1) & 0xFFFFu] & 0xFFu;
-        a = io[port] & 0xFFu; emit accumulatorChanged();
-        pc++; pc &= 0xFFFFu; emit programCounterChanged();
+        ioaddr_t port = readMemory((pc + 1) & 0xFFFFu) & 0xFFu;
+        if(ioDevices[port].device) a = ioDevices[port].device->read((port - ioDevices[port].first) & 0xFFu, cycles + 10u) & 0xFFu;
+        else a = io[port] & 0xFFu;
+        emit accumulatorChanged();
+        pc+=2; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //CC address (call on carry); hex machine code 0xDC.
     microprograms[CC]      = [&](){
         if(CHECK_FLAG(f, ZERO_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     microprograms[0xDDu]    = UNUSED;
     //SBI byte (subtract immediate from accumulator with borrow); hex machine code 0xDE.
     microprograms[SBI]      = [&](){
-        data8_t rhs = (memory[(pc + 1) & 0xFFFFu] & 0xFFu) + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u);
+        data8_t rhs = (readMemory((pc + 1) & 0xFFFFu) & 0xFFu) + (CHECK_FLAG(f, CARRY_FLAG) ? 1u : 0u);
         data8_calc_t temp = a + NEGATE8(rhs);
         SET_SPEC_FLAG(f, CARRY_FLAG, a < rhs); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (rhs & 0xFu)));
@@ -1779,9 +1801,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 3 (restart 3); hex machine code 0xDF.
     microprograms[RST_3]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 24u; emit programCounterChanged();
@@ -1789,32 +1811,32 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RPO (return on parity odd); hex machine code 0xE0.
     microprograms[RPO]       = [&](){
         if(!CHECK_FLAG(f, PARITY_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //POP H (pop HL from stack); hex machine code 0xE1.
     microprograms[POP_H]    = [&](){
-        l = memory[sp & 0xFFFFu]; sp++; emit registerLChanged();
-        h = memory[sp & 0xFFFFu]; sp++; emit registerHChanged(); emit MChanged();
+        l = readMemory(sp & 0xFFFFu); sp++; emit registerLChanged();
+        h = readMemory(sp & 0xFFFFu); sp++; emit registerHChanged(); emit MChanged();
         sp &= 0xFFFFu; emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JPO address (jump on parity odd); hex machine code 0xE2.
     microprograms[JPO]      = [&](){
         if(!CHECK_FLAG(f, PARITY_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //Exchange stack top with HL (XTHL); hex machine code 0xE3.
     microprograms[XTHL]     = [&](){
         data8_t temp;
-        SWAP(l, memory[sp & 0xFFFFu], temp); l &= 0xFFu; memory[sp & 0xFFFFu] &= 0xFFu;
+        temp = readMemory(sp & 0xFFFFu); writeMemory(sp & 0xFFFFu, l & 0xFFu); l = temp & 0xFFu;
         emit registerLChanged(); emit memoryBlockUpdated(sp & 0xFFFFu, 1u);
         sp++;
-        SWAP(h, memory[sp & 0xFFFFu], temp); h &= 0xFFu; memory[sp & 0xFFFFu] &= 0xFFu;
+        temp = readMemory(sp & 0xFFFFu); writeMemory(sp & 0xFFFFu, h & 0xFFu); h = temp & 0xFFu;
         emit registerHChanged(); emit memoryBlockUpdated(sp & 0xFFFFu, 1u);
         sp--;
         emit MChanged();
@@ -1824,27 +1846,27 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[CPO]      = [&](){
         if(!CHECK_FLAG(f, PARITY_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //PUSH H (push HL on stack); hex machine code 0xE5.
     microprograms[PUSH_H]   = [&](){
-        sp--; sp &= 0xFFFFu; memory[sp] = h & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, h & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = l & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, l & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //ANI byte (AND immediate with accumulator); hex machine code 0xE6.
     microprograms[ANI]      = [&](){
-        a = a & memory[(pc + 1) & 0xFFFFu] & 0xFFu; emit accumulatorChanged();
+        a = a & readMemory((pc + 1) & 0xFFFFu) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         SET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 1
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1855,9 +1877,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 4 (restart 4); hex machine code 0xE7.
     microprograms[RST_4]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 32u; emit programCounterChanged();
@@ -1865,7 +1887,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RPE (return on parity even); hex machine code 0xE8.
     microprograms[RPE]       = [&](){
         if(CHECK_FLAG(f, PARITY_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
@@ -1875,7 +1897,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //JPE address (jump on parity odd); hex machine code 0xEA.
     microprograms[JPE]      = [&](){
         if(CHECK_FLAG(f, PARITY_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -1892,19 +1914,19 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[CPE]      = [&](){
         if(CHECK_FLAG(f, PARITY_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     microprograms[0xEDu]    = UNUSED;
     //XRI byte (AND immediate with accumulator); hex machine code 0xEE.
     microprograms[XRI]      = [&](){
-        a = (a ^ memory[(pc + 1) & 0xFFFFu]) & 0xFFu; emit accumulatorChanged();
+        a = (a ^ readMemory((pc + 1) & 0xFFFFu)) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         UNSET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 0
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1915,9 +1937,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 5 (restart 5); hex machine code 0xEF.
     microprograms[RST_5]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 40u; emit programCounterChanged();
@@ -1925,22 +1947,22 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RP (return on Plus); hex machine code 0xF0.
     microprograms[RP]        = [&](){
         if(!CHECK_FLAG(f, SIGN_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //POP PSW (pop processor status word from stack); hex machine code 0xF1.
     microprograms[POP_PSW]    = [&](){
-        f = memory[sp & 0xFFFFu]; sp++; emit flagsChanged();
-        a = memory[sp & 0xFFFFu]; sp++; emit accumulatorChanged();
+        f = readMemory(sp & 0xFFFFu); sp++; emit flagsChanged();
+        a = readMemory(sp & 0xFFFFu); sp++; emit accumulatorChanged();
         sp &= 0xFFFFu; emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //JP address (jump on Plus); hex machine code 0xF2.
     microprograms[JP]       = [&](){
         if(!CHECK_FLAG(f, SIGN_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -1953,27 +1975,27 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[CP]       = [&](){
         if(!CHECK_FLAG(f, SIGN_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     //PUSH PSW (push processor status word on stack); hex machine code 0xF5.
     microprograms[PUSH_PSW]   = [&](){
-        sp--; sp &= 0xFFFFu; memory[sp] = a & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, a & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = f & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, f & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged();
         pc++; pc &= 0xFFFFu; emit programCounterChanged();
     };
     //ORI byte (OR immediate with accumulator); hex machine code 0xF6.
     microprograms[ORI]      = [&](){
-        a = (a | memory[(pc + 1) & 0xFFFFu]) & 0xFFu; emit accumulatorChanged();
+        a = (a | readMemory((pc + 1) & 0xFFFFu)) & 0xFFu; emit accumulatorChanged();
         UNSET_FLAG(f, CARRY_FLAG); //always 0
         UNSET_FLAG(f, AUXILIARY_CARRY_FLAG); //always 0
         SET_SPEC_FLAG(f, ZERO_FLAG, a == 0);
@@ -1984,9 +2006,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 6 (restart 6); hex machine code 0xF7.
     microprograms[RST_6]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 48u; emit programCounterChanged();
@@ -1994,7 +2016,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RM (return on Minus); hex machine code 0xF8.
     microprograms[RM]        = [&](){
         if(CHECK_FLAG(f, SIGN_FLAG)) {
-            pc = PACK(memory[(sp + 1u) & 0xFFFFu] & 0xFFu, memory[sp & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((sp + 1u) & 0xFFFFu) & 0xFFu, readMemory(sp & 0xFFFFu) & 0xFFu);
             sp+=2; sp &= 0xFFFFu; emit stackPointerChanged();
         } else pc++;
         pc &= 0xFFFFu; emit programCounterChanged();
@@ -2007,7 +2029,7 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //JM address (jump on Minus); hex machine code 0xFA.
     microprograms[JM]      = [&](){
         if(CHECK_FLAG(f, SIGN_FLAG))
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
@@ -2020,19 +2042,19 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     microprograms[CM]      = [&](){
         if(CHECK_FLAG(f, SIGN_FLAG)) {
             pc += 3; pc &= 0xFFFFu; //Go to immediate next instruction
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged(); pc -= 3; pc &= 0xFFFFu; //Go to previous correct location
-            pc = PACK(memory[(pc + 2u) & 0xFFFFu] & 0xFFu, memory[(pc + 1u) & 0xFFFFu] & 0xFFu);
+            pc = PACK(readMemory((pc + 2u) & 0xFFFFu) & 0xFFu, readMemory((pc + 1u) & 0xFFFFu) & 0xFFu);
         } else pc += 3;
         pc &= 0xFFFFu; emit programCounterChanged();
     };
     microprograms[0xFDu]    = UNUSED;
     //CPI byte (compare immediate against accumulator); hex machine code 0xFE.
     microprograms[CPI]      = [&](){
-        data8_t rhs = memory[(pc + 1) & 0xFFFFu] & 0xFFu;
+        data8_t rhs = readMemory((pc + 1) & 0xFFFFu) & 0xFFu;
         data8_calc_t temp = a + NEGATE8(rhs);
         SET_SPEC_FLAG(f, CARRY_FLAG, a < rhs); temp &= 0xFFu;
         SET_SPEC_FLAG(f, AUXILIARY_CARRY_FLAG, ((a & 0xFu) < (rhs & 0xFu)));
@@ -2045,9 +2067,9 @@ Processor::Processor(QObject *parent) //The content of this constructor is LARGE
     //RST 7 (restart 7); hex machine code 0xFF.
     microprograms[RST_7]    = [&](){
         pc++; pc &= 0xFFFFu; //Go to immediate next instruction
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged(); //pc--; pc &= 0xFFFFu; //Go to previous correct location (not required)
         pc = 56u; emit programCounterChanged();
@@ -2057,6 +2079,8 @@ Processor::~Processor() {
     delete[] microprograms;
     delete[] memory;
     delete[] io;
+    delete[] ioDevices;
+    delete[] pages;
 }
 void Processor::copyTo(data8_t *const dest, memaddr_t startLoc, memsize_t length) const {
     memaddr_t srcAddr; memsize_t destLoc;
@@ -2077,63 +2101,102 @@ void Processor::overwrite(const data8_t *const src, memaddr_t startLoc, memsize_
     emit MChanged();
 }
 void Processor::runFull() {
-    halt = unused = 0u;
-    while(!halt && !unused && stepNextInstruction());
-    halt = unused = 0u;
+    halt = unused = romFault = 0u;
+    while(!halt && !unused && !romFault && stepNextInstruction());
+    halt = unused = romFault = 0u;
+}
+///True if the condition in bits D5-D3 of a conditional return, jump or call opcode holds for the given flags.
+static inline bool isConditionMet(data8_t code, flags_t flags) {
+    switch((code >> 3) & 7u) {
+    case 0: return !CHECK_FLAG(flags, ZERO_FLAG);   //NZ
+    case 1: return CHECK_FLAG(flags, ZERO_FLAG);    //Z
+    case 2: return !CHECK_FLAG(flags, CARRY_FLAG);  //NC
+    case 3: return CHECK_FLAG(flags, CARRY_FLAG);   //C
+    case 4: return !CHECK_FLAG(flags, PARITY_FLAG); //PO
+    case 5: return CHECK_FLAG(flags, PARITY_FLAG);  //PE
+    case 6: return !CHECK_FLAG(flags, SIGN_FLAG);   //P
+    default: return CHECK_FLAG(flags, SIGN_FLAG);   //M
+    }
 }
 #include <QCoreApplication>
+///Length of the opcode fetch machine cycle (M1) of code: 6 T-states for the instructions which work on a 16 bit value in it.
+static inline cycles_t opcodeFetchTStates(data8_t code) {
+    switch(code & 0xC7u) {
+    case 0x03u: case 0xC0u: case 0xC4u: case 0xC7u: return 6u; //INX/DCX, Rcc, Ccc, RST
+    case 0xC5u: return !(code & 0x08u) || code == 0xCDu ? 6u : 4u; //PUSH, CALL
+    case 0xC1u: return code == 0xE9u || code == 0xF9u ? 6u : 4u; //PCHL, SPHL
+    default: return 4u;
+    }
+}
 bool Processor::stepNextInstruction() {
-    microprograms[memory[pc & 0xFFFFu] & 0xFFu]();
+    romFault = 0u;
+    busCycle = cycles + 1u; //the fetch below ends at T4
+    const data8_t code = readMemory(pc & 0xFFFFu) & 0xFFu;
+    busCycle = cycles + opcodeFetchTStates(code);
+    cycles_t spent = tStatesByCode[code];
+    if(TSTATES_EXTRA_ON_CONDITION_MET(code) && isConditionMet(code, f)) spent += TSTATES_EXTRA_ON_CONDITION_MET(code);
+    microprograms[code]();
+    cycles += spent;
+    //Fire scheduled events which are now due. This is only a comparison unless a deadline has been reached.
+    if(cycles >= scheduler.nextDeadline()) scheduler.dispatch(cycles);
+    if(romFault) emit romWriteTrapped(romFaultAddress);
     //Check HALT
     if(halt) {
         emit halted(); emit stepped(); return false;}
+    busCycle = cycles + 6u; //an interrupt acknowledge pushes PC like RST does
     //Check TRAP
     if(trap_lowToHigh) {
         trap_lowToHigh = 0; //Disable next TRAP. Now we need a function call to 0024H.
-        sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-        sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+        sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
         emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
         emit stackPointerChanged();
         pc = 0x0024u; emit programCounterChanged();
+        cycles += 12u; //Same as an RST instruction
     }
     else if(ie) {//Only do the next checks if interrupts are enabled
         if(!m7_5 && rst7_5) {
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged();
             pc = 0x003Cu; emit programCounterChanged();
+            rst7_5 = 0u; emit restart7_5RequestStatusChanged(); //the RST 7.5 flip-flop is reset on recognition
+            cycles += 12u; //Same as an RST instruction
             ie = 0u; emit interruptEnableStatusChanged(); //interrupts are disabled on recognising one
         }
         else if (!m6_5 && rst6_5) {
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged();
             pc = 0x0034u; emit programCounterChanged();
+            cycles += 12u; //Same as an RST instruction
             ie = 0u; emit interruptEnableStatusChanged(); //interrupts are disabled on recognising one
         }
         else if (!m5_5 && rst5_5) {
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged();
             pc = 0x002Cu; emit programCounterChanged();
+            cycles += 12u; //Same as an RST instruction
             ie = 0u; emit interruptEnableStatusChanged(); //interrupts are disabled on recognising one
         }
         else if (intr) {
             //INTA signal is sent ONLY on INTR; not for the other nonvectored interrupts.
             inta = 1u; emit interruptAcknowledgeStatusChanged(); QCoreApplication::processEvents(); //send this immediately
-            sp--; sp &= 0xFFFFu; memory[sp] = (pc >> 8) & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, (pc >> 8) & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
-            sp--; sp &= 0xFFFFu; memory[sp] = pc & 0xFFu;
+            sp--; sp &= 0xFFFFu; writeMemory(sp, pc & 0xFFu);
             emit memoryBlockUpdated(sp, 1u); if(sp == PACK(h, l)) emit MChanged();
             emit stackPointerChanged();
             pc = (intrVec << 3) & 0xFFFFu; emit programCounterChanged();
+            cycles += 12u; //Same as an RST instruction
             inta = 0u; emit interruptAcknowledgeStatusChanged(); QCoreApplication::processEvents(); //send this immediately
             ie = 0u; emit interruptEnableStatusChanged(); //interrupts are disabled on recognising one
         }
@@ -2161,8 +2224,66 @@ void Processor::setTRAPRequest(bool flag) {
     else if (!flag) trap = 0u;
 }
 void Processor::setInterruptRequest(bool flag) {intr = flag ? 1u : 0u;}
+void Processor::setInterruptLine(InterruptLine line, bool level) {
+    switch(line) {
+    case TRAP_LINE: setTRAPRequest(level); break;
+    case RST7_5_LINE: if(level) setRestart7_5Request(true); break;
+    case RST6_5_LINE: setRestart6_5Request(level); break;
+    case RST5_5_LINE: setRestart5_5Request(level); break;
+    case INTR_LINE: setInterruptRequest(level); break;
+    default: break;
+    }
+}
 void Processor::setINTRVector(data8_t value) {intrVec = (value >> 3) & 7u;}
 void Processor::setProgramCounter(memaddr_t value) {pc = value & 0xFFFF; emit programCounterChanged();}
+void Processor::scheduleTRAPRequest(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setTRAPRequest(flag);});}
+void Processor::scheduleRestart7_5Request(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setRestart7_5Request(flag);});}
+void Processor::scheduleRestart6_5Request(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setRestart6_5Request(flag);});}
+void Processor::scheduleRestart5_5Request(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setRestart5_5Request(flag);});}
+void Processor::scheduleInterruptRequest(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setInterruptRequest(flag);});}
+void Processor::scheduleSerialInputLatch(cycles_t when, bool flag) {scheduler.schedule(when, [=](){setSerialInputLatch(flag);});}
+void Processor::scheduleInputByte(cycles_t when, ioaddr_t address, data8_t data) {
+    scheduler.schedule(when, [=](){setInputByte(address, data);});
+}
+void Processor::clearScheduledEvents() {scheduler.clear();}
+data8_t Processor::readMappedMemory(memaddr_t address) {
+    const MemoryPage &page = pages[address >> MEMORY_PAGE_BITS];
+    const memaddr_t offset = (address - page.first) & 0xFFFFu;
+    if(page.type == DEVICE_PAGE && page.device && offset < page.length) return page.device->read(offset, busCycle) & 0xFFu;
+    return 0xFFu; //nothing drives the bus
+}
+void Processor::writeMappedMemory(memaddr_t address, data8_t data) {
+    const MemoryPage &page = pages[address >> MEMORY_PAGE_BITS];
+    const memaddr_t offset = (address - page.first) & 0xFFFFu;
+    switch(page.type) {
+    case DEVICE_PAGE: if(page.device && offset < page.length) page.device->write(offset, data & 0xFFu, busCycle); break;
+    case ROM_PAGE: if(trapROMWrites) {romFault = 1u; romFaultAddress = address;} break;
+    default: break; //unmapped
+    }
+}
+void Processor::mapMemory(memaddr_t first, memsize_t length, MemoryPageType type, IODevice *device) {
+    if(!length) return;
+    first &= 0xFFFFu;
+    if(length > MEMORY_SIZE - first) length = MEMORY_SIZE - first; //the map does not wrap around
+    memsize_t firstPage = first >> MEMORY_PAGE_BITS;
+    memsize_t lastPage = (first + length - 1u) >> MEMORY_PAGE_BITS;
+    for(memsize_t i = firstPage; i <= lastPage; i++) {
+        pages[i].type = type; pages[i].device = type == DEVICE_PAGE ? device : nullptr;
+        pages[i].first = first; pages[i].length = length;
+    }
+}
+void Processor::attachIODevice(ioaddr_t first, unsigned count, IODevice *device) {
+    if(count > IO_PORT_SIZE) count = IO_PORT_SIZE;
+    for(unsigned i = 0; i < count; i++) {
+        IOPortMapping &mapping = ioDevices[(first + i) & 0xFFu];
+        mapping.device = device; mapping.first = first;
+    }
+}
+void Processor::detachIODevice(IODevice *device) {
+    for(unsigned i = 0; i < IO_PORT_SIZE; i++) if(ioDevices[i].device == device) {
+        ioDevices[i].device = nullptr; ioDevices[i].first = i;
+    }
+}
 void Processor::resetMemory() {
     std::memset((void *)memory, 0, sizeof(data8_t) * MEMORY_SIZE);
     emit memoryBlockUpdated(0u, MEMORY_SIZE);
@@ -2174,9 +2295,22 @@ void Processor::resetIOPorts() {
 }
 void Processor::RESET_IN() {
     haltExecution(); QCoreApplication::processEvents();//halt if running
-    pc = sp = 0u;
+    pc = sp = 0u; cycles = busCycle = 0u; romFault = 0u;
+    scheduler.clear(); //deadlines refer to the old timeline
     a = b = c = d = e = h = l = 0u; f = 0u; ie = sod = inta = rst7_5 = halt = 0u;
     m5_5 = m6_5 = m7_5 = 1u; //Initial state is these external interrupts are masked.
+    for(unsigned i = 0; i < IO_PORT_SIZE; i++) if(ioDevices[i].device) { //reset each attached device once
+        unsigned j = 0; while(j < i && ioDevices[j].device != ioDevices[i].device) j++;
+        if(j == i) ioDevices[i].device->reset();
+    }
+    for(unsigned i = 0; i < MEMORY_PAGE_COUNT; i++) if(pages[i].type == DEVICE_PAGE && pages[i].device) { //and each mapped one
+        IODevice * const device = pages[i].device;
+        bool seen = false;
+        for(unsigned j = 0; j < IO_PORT_SIZE && !seen; j++) seen = ioDevices[j].device == device;
+        for(unsigned j = 0; j < i && !seen; j++) seen = pages[j].type == DEVICE_PAGE && pages[j].device == device;
+        if(!seen) device->reset();
+    }
+    if(serialDevice) serialDevice->reset();
     emit accumulatorChanged(); emit registerBChanged(); emit registerCChanged(); emit registerDChanged();
     emit registerEChanged(); emit registerHChanged(); emit registerLChanged(); emit flagsChanged();
     emit MChanged(); emit interruptEnableStatusChanged(); emit maskRestart5_5Changed();
@@ -30,6 +30,8 @@ furnished to do so, subject to the following conditions:
 #include <iostream>
 #include "commdefs.h"
 #include "opcodes.h" //Include here. This header requires typedefs defined above.
+#include "scheduler.h"
+#include "iodevice.h"
 
 /// Models an 8085 processor.
 class Processor : public QObject
@@ -42,8 +44,15 @@ class Processor : public QObject
     volatile data8_t * const memory;
     ///All I/O port latches for the 8085.
     volatile data8_t * const io;
+    ///Device attached to each I/O port (device is nullptr for plain latches, which are handled inline).
+    IOPortMapping * const ioDevices;
+    ///Memory map; one entry per 256 byte page.
+    MemoryPage * const pages;
 
-    //The above 3 are kept track of separately to prevent the size of the Processor object from getting overtly large.
+    //The above 5 are kept track of separately to prevent the size of the Processor object from getting overtly large.
+
+    ///Device wired to SOD/SID, if any.
+    SerialLineDevice *serialDevice;
 
     ///Accumulator register
     volatile data8_t a;
@@ -99,6 +108,36 @@ class Processor : public QObject
     volatile unsigned halt : 1;
     ///Flag which gets set on unused/invalid instruction use.
     volatile unsigned unused : 1;
+    ///Flag which gets set when a program write to ROM is trapped.
+    volatile unsigned romFault : 1;
+    ///If true, program writes to ROM pages stop execution (romWriteTrapped() is fired); otherwise they are ignored.
+    bool trapROMWrites;
+    ///Address of the last trapped ROM write.
+    memaddr_t romFaultAddress;
+    ///Clock cycles (T-states) elapsed since the last RESET_IN.
+    volatile cycles_t cycles;
+    ///Cycle count at the end of the current memory machine cycle: set after the opcode fetch and advanced by 3 T-states on
+    ///every readMemory()/writeMemory(), so memory-mapped devices see the same timing IN/OUT give to port devices.
+    cycles_t busCycle;
+    ///Externally scheduled events (interrupt requests, port inputs, etc.) keyed by cycle count.
+    EventScheduler scheduler;
+
+    ///Read a byte the way the running program does (through the memory map). RAM and ROM pages cost one table lookup.
+    data8_t readMemory(memaddr_t address) {
+        address &= 0xFFFFu; busCycle += 3u;
+        if(pages[address >> MEMORY_PAGE_BITS].type <= ROM_PAGE) return memory[address];
+        return readMappedMemory(address);
+    }
+    ///Write a byte the way the running program does (through the memory map). RAM pages cost one table lookup.
+    void writeMemory(memaddr_t address, data8_t data) {
+        address &= 0xFFFFu; busCycle += 3u;
+        if(pages[address >> MEMORY_PAGE_BITS].type == RAM_PAGE) memory[address] = data;
+        else writeMappedMemory(address, data);
+    }
+    ///readMemory() for unmapped and device pages.
+    data8_t readMappedMemory(memaddr_t address);
+    ///writeMemory() for ROM, unmapped and device pages.
+    void writeMappedMemory(memaddr_t address, data8_t data);
 public:
     ///Initializes this processor. All data storage locations (memory and all registers) are set to 0 (except the interrupt mask
     ///bits, which are set to 1).
@@ -165,6 +204,49 @@ public:
     data8_t getMemoryByte(memaddr_t index) const {return memory[index & 0xFFFFu];}
     ///Gets the byte stored at the I/O port latch referred to by index.
     data8_t getOutputByte(ioaddr_t index) const {return io[index & 0xFFu];}
+    ///Get the number of clock cycles (T-states) elapsed since the last RESET_IN.
+    cycles_t getCycleCount() const {return cycles;}
+    ///Get the cycle count at which the earliest scheduled event is due (CYCLES_MAX if none is pending).
+    cycles_t nextScheduledEvent() const {return scheduler.nextDeadline();}
+    ///Schedule action to be performed once the cycle count reaches when. Actions are performed between instructions (after the
+    ///instruction which reaches the deadline and before interrupts are checked), in order of their deadlines; events due at the
+    ///same cycle are performed in the order they were scheduled. RESET_IN drops every pending event, since the cycle count
+    ///restarts from 0; schedule against the new timeline after it.
+    void scheduleEvent(cycles_t when, const std::function<void()> &action) {scheduler.schedule(when, action);}
+    ///Attach device to count consecutive I/O ports starting from first (wrapping around after 0xFF); the device sees register
+    ///offsets 0 to count-1. IN/OUT on these ports are then routed to the device instead of the latches (which are left untouched
+    ///and do not emit ioPortUpdated()). Any device previously attached to these ports is replaced. The processor does not take
+    ///ownership of device. Must not be called while the processor is running.
+    void attachIODevice(ioaddr_t first, unsigned count, IODevice *device);
+    ///Detach device from every I/O port it is attached to; those ports become plain latches again. Must not be called while
+    ///the processor is running.
+    void detachIODevice(IODevice *device);
+    ///Wire device to the serial pins (nullptr to disconnect). While a device is attached, SIM passes SOD changes to it instead
+    ///of emitting serialOutput(), and RIM reads SID from it. The processor does not take ownership of device. Must not be called
+    ///while the processor is running.
+    void attachSerialLineDevice(SerialLineDevice *device) {serialDevice = device;}
+    ///Get the device wired to the serial pins, or nullptr.
+    SerialLineDevice *getSerialLineDevice() const {return serialDevice;}
+    ///Make the pages covering length bytes from address first (rounded outwards to 256 byte pages) of the given type. For
+    ///DEVICE_PAGE, device handles the accesses the program makes to those length bytes, with register offsets counted from
+    ///first; the rest of a partly covered page is unmapped. The processor does not take ownership of device. Only the running
+    ///program goes through the memory map: overwrite(), setMemoryByte(), copyTo() and the getters always access the
+    ///underlying 64K buffer, so ROM images are loaded with overwrite(). Must not be called while the processor is running.
+    void mapMemory(memaddr_t first, memsize_t length, MemoryPageType type, IODevice *device = nullptr);
+    ///Make the entire address space RAM again.
+    void resetMemoryMap() {mapMemory(0u, MEMORY_SIZE, RAM_PAGE);}
+    ///Get the type of the page containing address.
+    MemoryPageType getMemoryPageType(memaddr_t address) const {return pages[(address & 0xFFFFu) >> MEMORY_PAGE_BITS].type;}
+    ///If flag is true, a program write to ROM stops execution after the instruction and fires romWriteTrapped(); otherwise
+    ///(the default) such writes are silently ignored.
+    void setROMWriteTrap(bool flag) {trapROMWrites = flag;}
+    ///True if program writes to ROM are trapped.
+    bool isROMWriteTrapEnabled() const {return trapROMWrites;}
+    ///Drive interrupt input line to the given level, as a device output wired to it would. Only rising edges have an effect on
+    ///RST 7.5 (the request stays latched until recognised or cleared by SIM); the other lines follow level.
+    void setInterruptLine(InterruptLine line, bool level);
+    ///Get the device attached to I/O port index, or nullptr if it is a plain latch.
+    IODevice *getIODevice(ioaddr_t index) const {return ioDevices[index & 0xFFu].device;}
     ///Copy the current memory contents into dest; starting from startLoc address in this processor and copying length
     ///bytes. Note that while copying, if because of length, the addresses being copied overshoot 0xFFFF, this function
     ///"wraps around" and continues copying from 0x0000. If the destination buffer is smaller than length bytes, the
@@ -210,13 +292,30 @@ public slots:
     void setINTRVector(data8_t value);
     ///Sets the program counter externally. Emits programCounterChanged() signal.
     void setProgramCounter(memaddr_t value);
+    ///Calls setTRAPRequest(flag) once the cycle count reaches when.
+    void scheduleTRAPRequest(cycles_t when, bool flag);
+    ///Calls setRestart7_5Request(flag) once the cycle count reaches when.
+    void scheduleRestart7_5Request(cycles_t when, bool flag);
+    ///Calls setRestart6_5Request(flag) once the cycle count reaches when.
+    void scheduleRestart6_5Request(cycles_t when, bool flag);
+    ///Calls setRestart5_5Request(flag) once the cycle count reaches when.
+    void scheduleRestart5_5Request(cycles_t when, bool flag);
+    ///Calls setInterruptRequest(flag) once the cycle count reaches when.
+    void scheduleInterruptRequest(cycles_t when, bool flag);
+    ///Calls setSerialInputLatch(flag) once the cycle count reaches when.
+    void scheduleSerialInputLatch(cycles_t when, bool flag);
+    ///Calls setInputByte(address, data) once the cycle count reaches when.
+    void scheduleInputByte(cycles_t when, ioaddr_t address, data8_t data);
+    ///Drops every pending scheduled event.
+    void clearScheduledEvents();
 
     ///Resets entire memory to 0 (all 65,536 bytes, may take time). Fires memoryBlockUpdated() and MChanged() signals.
     void resetMemory();
     ///Resets all I/O port latches to 0. Fires ioPortsReset() signal.
     void resetIOPorts();
-    ///Resets the entire processor state EXCEPT MEMORY (all registers to 0). This is equivalent to the RESET_IN signal
-    ///to the 8085. Fires ALL signals EXCEPT memoryBlockUpdated(), ioPortUpdated() and ioPortsReset() signals. Note that this
+    ///Resets the entire processor state EXCEPT MEMORY (all registers and the cycle count to 0, pending scheduled events are
+    ///dropped and every attached I/O or serial line device is reset). This is equivalent to the RESET_IN signal to the 8085.
+    ///Fires ALL signals EXCEPT memoryBlockUpdated(), ioPortUpdated() and ioPortsReset() signals. Note that this
     ///does NOT stop the processor if it is running (simulating instruction execution in its memory) on another thread. In that
     ///case, haltExecution() must be called and wait for the other thread to finish.
     void RESET_IN();
@@ -276,6 +375,8 @@ signals:
     void halted();
     ///Fired when processor encounters an unused instruction value.
     void unusedInstruction(data8_t);
+    ///Fired when the program writes to a ROM page while ROM write trapping is enabled; address is the one written to.
+    void romWriteTrapped(memaddr_t address);
     ///Fired from stepNextInstruction() just before it returns.
     void stepped();
 };
@@ -0,0 +1,41 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "scheduler.h"
+
+//EventScheduler
+
+void EventScheduler::schedule(cycles_t when, const std::function<void()> &action) {
+    queue.push(ScheduledEvent{when, nextSequence++, action});
+    if(when < deadline) deadline = when;
+}
+void EventScheduler::dispatch(cycles_t now) {
+    while(!queue.empty() && queue.top().when <= now) {
+        std::function<void()> action = queue.top().action; //copy out; the action may schedule further events
+        queue.pop();
+        deadline = queue.empty() ? CYCLES_MAX : queue.top().when;
+        action();
+    }
+}
+void EventScheduler::clear() {
+    queue = std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, ScheduledEventComparator>();
+    deadline = CYCLES_MAX;
+}
@@ -0,0 +1,74 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <functional>
+#include <queue>
+#include <vector>
+#include "commdefs.h"
+
+///An action scheduled to be performed once the processor cycle count reaches a given value.
+struct ScheduledEvent {
+    ///Cycle count (T-states since RESET_IN) at which this event is due.
+    cycles_t when;
+    ///Order in which this event was scheduled. Events due at the same cycle fire in the order they were scheduled; this keeps
+    ///runs reproducible.
+    unsigned long long sequence;
+    ///What to do when this event is due.
+    std::function<void()> action;
+};
+
+///Orders ScheduledEvent objects so that a std::priority_queue keeps the earliest (and then the first scheduled) on top.
+struct ScheduledEventComparator {
+    bool operator()(const ScheduledEvent &a, const ScheduledEvent &b) const {
+        return a.when != b.when ? a.when > b.when : a.sequence > b.sequence;
+    }
+};
+
+///Cycle-timestamped event queue (a binary heap). The owner only needs to compare its cycle count against nextDeadline() after each
+///instruction and call dispatch() when the deadline has been reached; an empty queue has a deadline of CYCLES_MAX.
+class EventScheduler {
+    ///Pending events, earliest on top.
+    std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, ScheduledEventComparator> queue;
+    ///Sequence number to be given to the next scheduled event.
+    unsigned long long nextSequence;
+    ///Cached deadline of the event on top of the queue (CYCLES_MAX if empty).
+    cycles_t deadline;
+public:
+    ///Constructor. The queue is initially empty.
+    EventScheduler() : nextSequence(0u), deadline(CYCLES_MAX) {}
+    ///Schedule action to be performed at cycle count when. If when has already passed, the action is performed on the next
+    ///call to dispatch().
+    void schedule(cycles_t when, const std::function<void()> &action);
+    ///Perform (and remove) every event due at or before now, in order. Events scheduled by these actions which are also due
+    ///by now are performed in the same call.
+    void dispatch(cycles_t now);
+    ///Remove all pending events without performing them.
+    void clear();
+    ///Cycle count at which the earliest pending event is due; CYCLES_MAX if nothing is pending.
+    cycles_t nextDeadline() const {return deadline;}
+    ///Number of pending events.
+    size_t size() const {return queue.size();}
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,60 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include <QTextCursor>
+#include <QFontDatabase>
+#include <QScrollBar>
+#include "serialconsole.h"
+
+SerialConsole::SerialConsole(QWidget *parent) : QPlainTextEdit(parent) {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setUndoRedoEnabled(false);
+    setReadOnly(true); //only what the line sends is shown; typed keys go to the line (see keyPressEvent())
+    setMaximumBlockCount(10000); //keep a long running program from using up memory
+}
+void SerialConsole::keyPressEvent(QKeyEvent *event) {
+    QByteArray data;
+    switch(event->key()) {
+    case Qt::Key_Return: case Qt::Key_Enter: data.append('\r'); break;
+    case Qt::Key_Backspace: data.append('\b'); break;
+    case Qt::Key_Escape: data.append('\x1B'); break;
+    default: data = event->text().toLatin1(); break;
+    }
+    if(data.isEmpty()) {QPlainTextEdit::keyPressEvent(event); return;} //navigation, copying etc.
+    emit inputTyped(data);
+}
+void SerialConsole::appendOutput(const QByteArray &data) {
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    QString text;
+    for(int i = 0; i < data.size(); i++) {
+        switch(data[i]) {
+        case '\r': break;
+        case '\b':
+            if(!text.isEmpty()) text.chop(1);
+            else cursor.deletePreviousChar();
+            break;
+        default: text.append(QChar::fromLatin1(data[i])); break;
+        }
+    }
+    cursor.insertText(text);
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
@@ -0,0 +1,50 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef SERIALCONSOLE_H
+#define SERIALCONSOLE_H
+
+#include <QPlainTextEdit>
+#include <QObject>
+#include <QWidget>
+#include <QByteArray>
+#include <QKeyEvent>
+
+///Terminal for a simulated serial line (see BufferedSerialEndpoint). Characters received from the line are appended at the
+///end; keys typed into it are not shown but sent to the line (Enter sends a carriage return), as on a real terminal where the
+///program echoes what it wants shown.
+class SerialConsole : public QPlainTextEdit {
+    Q_OBJECT
+public:
+    ///Constructor
+    SerialConsole(QWidget *parent = nullptr);
+protected:
+    ///Send the typed character to the line instead of inserting it.
+    void keyPressEvent(QKeyEvent *event); //override
+public slots:
+    ///Show characters received from the line. Carriage returns are dropped and backspaces erase the last character.
+    void appendOutput(const QByteArray &data);
+signals:
+    ///Characters typed by the user, to be sent to the line.
+    void inputTyped(const QByteArray &data);
+};
+
+#endif // SERIALCONSOLE_H
@@ -0,0 +1,76 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "serialendpoint.h"
+
+//StreamSerialEndpoint
+
+bool StreamSerialEndpoint::receive(data8_t &byte) {
+    if(!in || !*in) return false;
+    std::streambuf *source = in->rdbuf();
+    if(!source || source->in_avail() <= 0) return false; //nothing there without blocking (or end of stream)
+    byte = std::char_traits<char>::to_int_type(source->sbumpc()) & 0xFFu;
+    return true;
+}
+void StreamSerialEndpoint::transmit(data8_t byte) {
+    buffer.push_back((char)byte);
+    if(byte == '\n' || buffer.size() >= capacity) flush();
+}
+void StreamSerialEndpoint::flush() {
+    if(buffer.empty()) return;
+    if(out) {out->write(buffer.data(), buffer.size()); out->flush();}
+    buffer.clear();
+}
+
+//BufferedSerialEndpoint
+
+bool BufferedSerialEndpoint::receive(data8_t &byte) {
+    std::lock_guard<std::mutex> guard(lock);
+    if(input.empty()) return false;
+    byte = input.front(); input.pop_front();
+    return true;
+}
+void BufferedSerialEndpoint::transmit(data8_t byte) {
+    bool full;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        output.append((char)byte);
+        full = byte == '\n' || output.size() >= capacity;
+    }
+    if(full) flush();
+}
+void BufferedSerialEndpoint::feedInput(const QByteArray &data) {
+    std::lock_guard<std::mutex> guard(lock);
+    for(int i = 0; i < data.size(); i++) input.push_back((data8_t)data[i] & 0xFFu);
+}
+void BufferedSerialEndpoint::clearInput() {
+    std::lock_guard<std::mutex> guard(lock);
+    input.clear();
+}
+void BufferedSerialEndpoint::flush() {
+    QByteArray data;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if(output.isEmpty()) return;
+        data.swap(output); //emit outside the lock
+    }
+    emit outputReady(data);
+}
@@ -0,0 +1,103 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef SERIALENDPOINT_H
+#define SERIALENDPOINT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <iostream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include "commdefs.h"
+
+///Host side of a simulated serial line: where characters transmitted by the simulated program go, and where the characters
+///it receives come from. Serial devices call receive() and transmit() from the processor's execution thread; transmitted
+///characters are buffered and handed over in bulk by flush().
+class SerialEndpoint {
+public:
+    virtual ~SerialEndpoint() = default;
+    ///If a character is available for the simulated program, remove it into byte and return true. Never blocks.
+    virtual bool receive(data8_t &byte) = 0;
+    ///Queue a character transmitted by the simulated program.
+    virtual void transmit(data8_t byte) = 0;
+    ///Hand over every queued transmitted character.
+    virtual void flush() = 0;
+};
+
+///Serial endpoint over standard C++ streams: std::cin/std::cout for a command line front end, or file streams opened on a
+///pipe or pty. Either stream may be nullptr. Output is flushed on newline, when capacity characters are queued, and on
+///flush(). Input is only taken when the stream buffer reports it available without blocking (for std::cin, call
+///std::ios::sync_with_stdio(false) so that this works).
+class StreamSerialEndpoint : public SerialEndpoint {
+    ///Characters for the simulated program.
+    std::istream *in;
+    ///Where transmitted characters go.
+    std::ostream *out;
+    ///Queued transmitted characters.
+    std::string buffer;
+    ///Flush once this many characters are queued.
+    size_t capacity;
+public:
+    ///Constructor.
+    StreamSerialEndpoint(std::istream *in, std::ostream *out, size_t capacity = 256u)
+        : in(in), out(out), capacity(capacity ? capacity : 1u) {buffer.reserve(this->capacity);}
+    ///Flushes pending output.
+    ~StreamSerialEndpoint() {flush();}
+    bool receive(data8_t &byte); //override
+    void transmit(data8_t byte); //override
+    void flush(); //override
+};
+
+///Serial endpoint for a console widget (or any other Qt consumer). Transmitted characters are queued and delivered by one
+///outputReady() signal per flush (on newline, when capacity characters are queued, and when flush() is called, e.g. on
+///Processor::halted()). Characters typed into the console are queued with feedInput(). Safe to use across threads.
+class BufferedSerialEndpoint : public QObject, public SerialEndpoint
+{
+    Q_OBJECT
+    ///Guards both queues.
+    std::mutex lock;
+    ///Characters for the simulated program.
+    std::deque<data8_t> input;
+    ///Queued transmitted characters.
+    QByteArray output;
+    ///Flush once this many characters are queued.
+    int capacity;
+public:
+    ///Constructor.
+    explicit BufferedSerialEndpoint(int capacity = 256, QObject *parent = nullptr)
+        : QObject(parent), capacity(capacity > 0 ? capacity : 1) {}
+    bool receive(data8_t &byte); //override
+    void transmit(data8_t byte); //override
+public slots:
+    ///Queue characters for the simulated program.
+    void feedInput(const QByteArray &data);
+    ///Drop every character not yet received by the simulated program.
+    void clearInput();
+    ///Emit outputReady() with every queued transmitted character (nothing is emitted if none are queued).
+    void flush(); //override
+signals:
+    ///Characters transmitted by the simulated program.
+    void outputReady(const QByteArray &data);
+};
+
+#endif // SERIALENDPOINT_H
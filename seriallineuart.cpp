@@ -0,0 +1,88 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "seriallineuart.h"
+
+SerialLineUart::SerialLineUart(Processor *processor, SerialEndpoint *endpoint, cycles_t cyclesPerBit, unsigned dataBits)
+    : processor(processor), endpoint(endpoint), cyclesPerBit(cyclesPerBit ? cyclesPerBit : 1u), generation(0u) {
+    setDataBits(dataBits);
+    reset();
+}
+
+bool SerialLineUart::outputLevelAt(cycles_t t) const {
+    bool level = false; //start bit
+    for(const std::pair<cycles_t, bool> &edge : edges) {
+        if(edge.first > t) break;
+        level = edge.second;
+    }
+    return level;
+}
+void SerialLineUart::beginFrame(cycles_t start) {
+    receiving = true; frameStart = start; edges.clear();
+    unsigned long long current = generation;
+    //Decode in the middle of the stop bit
+    processor->scheduleEvent(start + cyclesPerBit * (dataBits + 1u) + cyclesPerBit / 2u, [this, current](){
+        if(generation == current && receiving) endFrame();
+    });
+}
+void SerialLineUart::endFrame() {
+    cycles_t half = cyclesPerBit / 2u, stop = frameStart + cyclesPerBit * (dataBits + 1u) + half;
+    receiving = false;
+    if(!outputLevelAt(frameStart + half)) { //start bit still low in its middle; otherwise it was a glitch
+        data8_t byte = 0u;
+        for(unsigned i = 0; i < dataBits; i++)
+            if(outputLevelAt(frameStart + cyclesPerBit * (i + 1u) + half)) byte |= 1u << i;
+        if(outputLevelAt(stop) && endpoint) endpoint->transmit(byte); //dropped on a framing error
+    }
+    //The next start bit may already have begun
+    for(const std::pair<cycles_t, bool> &edge : edges) if(edge.first > stop && !edge.second) {
+        std::vector<std::pair<cycles_t, bool>> rest;
+        for(const std::pair<cycles_t, bool> &later : edges) if(later.first > edge.first) rest.push_back(later);
+        beginFrame(edge.first);
+        edges.swap(rest);
+        break;
+    }
+}
+
+void SerialLineUart::serialOutputChanged(bool level, cycles_t now) {
+    if(level == outputLevel) return;
+    outputLevel = level;
+    if(receiving) edges.push_back(std::make_pair(now, level));
+    else if(!level) beginFrame(now);
+}
+bool SerialLineUart::serialInputLevel(cycles_t now) {
+    if(sending) {
+        cycles_t bit = (now - sendStart) / cyclesPerBit;
+        if(!bit) return false; //start bit
+        if(bit <= dataBits) return (sendByte >> (bit - 1u)) & 1u;
+        if(bit == dataBits + 1u) return true; //stop bit
+        sending = false;
+    }
+    if(endpoint && endpoint->receive(sendByte)) {sending = true; sendStart = now; return false;}
+    return true; //idle
+}
+void SerialLineUart::reset() {
+    outputLevel = false; //SOD is cleared by RESET_IN
+    receiving = sending = false;
+    frameStart = sendStart = 0u; sendByte = 0u;
+    edges.clear();
+    generation++;
+}
@@ -0,0 +1,90 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef SERIALLINEUART_H
+#define SERIALLINEUART_H
+
+#include <vector>
+#include <utility>
+#include "processor.h"
+#include "serialendpoint.h"
+
+///Software (bit-banged) UART on the processor's SOD and SID pins, connected to a host serial endpoint. Frames are 1 start bit,
+///dataBits data bits (least significant first) and 1 stop bit, at cyclesPerBit T-states per bit.
+///
+///Nothing is sampled per cycle. SOD is decoded from the times at which SIM changed it: a falling edge on an idle line starts a
+///frame and one scheduled event, in the middle of its stop bit, reads the data bits back from the recorded edges. SID is
+///encoded on demand: when RIM samples an idle line and the endpoint has a character, a frame starts at that instant and its
+///level at any later RIM is computed from the elapsed cycles. (So the program must be polling SID for a start bit when a
+///character is due, as bit-banged receive routines do.)
+class SerialLineUart : public SerialLineDevice {
+    ///Processor this UART is wired to.
+    Processor * const processor;
+    ///Host side of the serial line (may be nullptr).
+    SerialEndpoint *endpoint;
+    ///Processor clock cycles (T-states) per bit.
+    cycles_t cyclesPerBit;
+    ///Data bits per frame (5 to 8).
+    unsigned dataBits;
+
+    ///Last SOD level seen.
+    bool outputLevel;
+    ///True while a frame is being received on SOD.
+    bool receiving;
+    ///Cycle count of the start bit (falling edge) of the frame being received.
+    cycles_t frameStart;
+    ///SOD changes (cycle count, new level) since frameStart.
+    std::vector<std::pair<cycles_t, bool>> edges;
+    ///Incremented on reset; scheduled decode events carrying an older generation are ignored.
+    unsigned long long generation;
+
+    ///True while a frame is being sent on SID.
+    bool sending;
+    ///Character being sent on SID.
+    data8_t sendByte;
+    ///Cycle count of the start bit of the frame being sent.
+    cycles_t sendStart;
+
+    ///SOD level at cycle count t within the frame being received.
+    bool outputLevelAt(cycles_t t) const;
+    ///Start receiving a frame whose start bit began at cycle count start.
+    void beginFrame(cycles_t start);
+    ///Decode the frame being received (its stop bit has been reached) and pass the character on to the endpoint.
+    void endFrame();
+public:
+    ///Constructor.
+    SerialLineUart(Processor *processor, SerialEndpoint *endpoint, cycles_t cyclesPerBit, unsigned dataBits = 8u);
+
+    void serialOutputChanged(bool level, cycles_t now); //override
+    bool serialInputLevel(cycles_t now); //override
+    void reset(); //override
+
+    ///Change the host side of the serial line. Must not be called while the processor is running.
+    void setEndpoint(SerialEndpoint *value) {endpoint = value;}
+    ///Set the number of processor T-states per bit (at least 1).
+    void setCyclesPerBit(cycles_t value) {cyclesPerBit = value ? value : 1u;}
+    ///Get the number of processor T-states per bit.
+    cycles_t getCyclesPerBit() const {return cyclesPerBit;}
+    ///Set the number of data bits per frame (5 to 8).
+    void setDataBits(unsigned value) {dataBits = value < 5u ? 5u : value > 8u ? 8u : value;}
+};
+
+#endif // SERIALLINEUART_H
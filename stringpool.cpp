@@ -0,0 +1,87 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "stringpool.h"
+#include <cstring>
+#include <cctype>
+#include <string>
+
+StringPool::StringPool() : blockUsed(BLOCK_SIZE), allocated(0u), buckets(64u, 0u) {
+    strings.push_back(""); lengths.push_back(0u); hashes.push_back(hash("", 0u)); keys.push_back(0u);
+}
+uint_least32_t StringPool::hash(const char *s, size_t length) {
+    uint_least32_t h = 0x811C9DC5u;
+    for(size_t i = 0; i < length; i++) {h ^= (unsigned char)s[i]; h = (h * 0x01000193u) & 0xFFFFFFFFu;}
+    return h;
+}
+const char *StringPool::store(const char *s, size_t length) {
+    char *dest;
+    if(length + 1u > BLOCK_SIZE / 4u) {
+        //Long (rare) string: a block of its own. The next short string starts a new block.
+        blocks.push_back(std::unique_ptr<char[]>(new char[length + 1u]));
+        dest = blocks.back().get();
+        blockUsed = BLOCK_SIZE; allocated += length + 1u;
+    } else {
+        if(blockUsed + length + 1u > BLOCK_SIZE) {
+            blocks.push_back(std::unique_ptr<char[]>(new char[BLOCK_SIZE]));
+            blockUsed = 0u; allocated += BLOCK_SIZE;
+        }
+        dest = blocks.back().get() + blockUsed;
+        blockUsed += length + 1u;
+    }
+    std::memcpy(dest, s, length);
+    dest[length] = '\0';
+    return dest;
+}
+string_id_t StringPool::intern(const char *s, size_t length) {
+    if(length == 0u) return 0u;
+    const uint_least32_t h = hash(s, length);
+    const size_t mask = buckets.size() - 1u;
+    size_t slot = h & mask;
+    for(; buckets[slot] != 0u; slot = (slot + 1u) & mask) {
+        const string_id_t id = buckets[slot];
+        if(hashes[id] == h && lengths[id] == length && std::memcmp(strings[id], s, length) == 0) return id;
+    }
+    const string_id_t id = (string_id_t)strings.size();
+    strings.push_back(store(s, length)); lengths.push_back((uint_least32_t)length); hashes.push_back(h); keys.push_back(id);
+    buckets[slot] = id;
+    if(strings.size() * 2u > buckets.size()) grow();
+    //The upper-cased spelling is its own key (the recursion stops there).
+    size_t k = 0;
+    while(k < length && !std::islower((unsigned char)s[k])) k++;
+    if(k < length) {
+        std::string upper(s, length);
+        for(; k < length; k++) upper[k] = (char)std::toupper((unsigned char)upper[k]);
+        const string_id_t key = intern(upper.data(), length);
+        keys[id] = key;
+    }
+    return id;
+}
+void StringPool::grow() {
+    std::vector<string_id_t> larger(buckets.size() * 2u, 0u);
+    const size_t mask = larger.size() - 1u;
+    for(string_id_t id = 1u; id < strings.size(); id++) {
+        size_t slot = hashes[id] & mask;
+        while(larger[slot] != 0u) slot = (slot + 1u) & mask;
+        larger[slot] = id;
+    }
+    buckets.swap(larger);
+}
@@ -0,0 +1,77 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+///Identifier for a string interned in a StringPool. 0 is always the empty string.
+typedef uint_least32_t string_id_t;
+
+///Interns strings: every distinct string is stored once and identified by a 32-bit id, so records referring to it stay
+///plain data. Characters are kept in large blocks which never move; str() pointers stay valid as long as the pool does.
+///Strings are never removed individually (drop the whole pool instead). Not thread-safe.
+class StringPool {
+public:
+    ///Constructor (the pool initially holds only the empty string).
+    StringPool();
+    ///Intern the given characters (need not be null-terminated) and return their identifier.
+    string_id_t intern(const char *s, size_t length);
+    ///Null-terminated text of an interned string.
+    const char *str(string_id_t id) const {return strings[id];}
+    ///Length of an interned string.
+    size_t length(string_id_t id) const {return lengths[id];}
+    ///Case-insensitive key of an interned string: the identifier of its upper-cased spelling. Computed once when the string
+    ///is interned, so that comparing names regardless of case is an integer comparison.
+    string_id_t key(string_id_t id) const {return keys[id];}
+    ///Number of distinct strings (including the empty string).
+    size_t size() const {return strings.size();}
+    ///Bytes of character storage allocated so far.
+    size_t bytesAllocated() const {return allocated;}
+private:
+    ///Size of a character block. Longer strings get a block of their own.
+    static const size_t BLOCK_SIZE = 4096u;
+    ///Character blocks.
+    std::vector<std::unique_ptr<char[]>> blocks;
+    ///Bytes used in the last block.
+    size_t blockUsed;
+    ///Bytes allocated in all blocks.
+    size_t allocated;
+    ///Text, length, hash and case-insensitive key of each string, indexed by identifier.
+    std::vector<const char *> strings;
+    std::vector<uint_least32_t> lengths;
+    std::vector<uint_least32_t> hashes;
+    std::vector<string_id_t> keys;
+    ///Open-addressing hash table (linear probing) of identifiers; 0 marks an empty slot. Size is a power of 2.
+    std::vector<string_id_t> buckets;
+    ///Hash function (32-bit FNV-1a).
+    static uint_least32_t hash(const char *s, size_t length);
+    ///Copy characters into block storage; returns the null-terminated copy.
+    const char *store(const char *s, size_t length);
+    ///Double the hash table.
+    void grow();
+};
+
+#endif // STRINGPOOL_H
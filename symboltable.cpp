@@ -0,0 +1,65 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "symboltable.h"
+#include <algorithm>
+
+const size_t Symbol::NO_PENDING;
+
+SymbolTable::SymbolTable() : buckets(64u, 0u) {}
+size_t SymbolTable::hash(symbol_key_t key) {
+    key ^= key >> 33; key *= 0xFF51AFD7ED558CCDull; key ^= key >> 33; //MurmurHash3 finalizer
+    return (size_t)key;
+}
+Symbol &SymbolTable::get(symbol_key_t key) {
+    const size_t mask = buckets.size() - 1u;
+    size_t slot = hash(key) & mask;
+    for(; buckets[slot] != 0u; slot = (slot + 1u) & mask) {
+        Entry &entry = entries[buckets[slot] - 1u];
+        if(entry.key == key) return entry.symbol;
+    }
+    entries.push_back(Entry{key, Symbol()});
+    buckets[slot] = (uint_least32_t)entries.size();
+    if(entries.size() * 2u > buckets.size()) grow();
+    return entries.back().symbol;
+}
+const Symbol *SymbolTable::find(symbol_key_t key) const {
+    const size_t mask = buckets.size() - 1u;
+    for(size_t slot = hash(key) & mask; buckets[slot] != 0u; slot = (slot + 1u) & mask) {
+        const Entry &entry = entries[buckets[slot] - 1u];
+        if(entry.key == key) return &entry.symbol;
+    }
+    return nullptr;
+}
+void SymbolTable::clear() {
+    entries.clear();
+    std::fill(buckets.begin(), buckets.end(), 0u);
+}
+void SymbolTable::grow() {
+    std::vector<uint_least32_t> larger(buckets.size() * 2u, 0u);
+    const size_t mask = larger.size() - 1u;
+    for(size_t k = 0; k < entries.size(); k++) {
+        size_t slot = hash(entries[k].key) & mask;
+        while(larger[slot] != 0u) slot = (slot + 1u) & mask;
+        larger[slot] = (uint_least32_t)(k + 1u);
+    }
+    buckets.swap(larger);
+}
@@ -0,0 +1,103 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "commdefs.h"
+#include "stringpool.h"
+
+///Key of a symbol in a SymbolTable: the case-insensitive name key (see StringPool::key) in the lower 32 bits, and for local
+///labels (names starting with '.') the key of the enclosing global label in the upper 32 bits.
+typedef uint_least64_t symbol_key_t;
+
+///Make the key of a symbol. scope is 0 for global symbols.
+inline symbol_key_t makeSymbolKey(string_id_t scope, string_id_t name) {return ((symbol_key_t)scope << 32) | name;}
+
+///A named value known to the assembler.
+struct Symbol {
+    ///Kinds of symbols
+    enum Kind : int {
+        ///Referred to, but not (yet) defined
+        UNDEFINED = 0,
+        ///Address of an instruction line
+        LABEL,
+        ///Constant (EQU); cannot be redefined
+        EQU,
+        ///Variable (SET); may be redefined by another SET
+        SET
+    } kind;
+    ///Value (the address, for labels).
+    data16_t value;
+    ///Is the value an offset from the start of a relocatable module rather than an address (see linker.h)?
+    bool relocatable;
+    ///Line which defined the symbol; 0 if undefined.
+    unsigned lineNumber;
+    ///Head of the chain of forward references waiting for the definition (owned by the assembler); NO_PENDING if none.
+    size_t pending;
+
+    ///Marks the end of a chain of forward references.
+    static const size_t NO_PENDING = (size_t)-1;
+    ///Constructor (undefined symbol)
+    Symbol() : kind(UNDEFINED), value(0u), relocatable(false), lineNumber(0u), pending(NO_PENDING) {}
+    ///Is the symbol defined?
+    bool isDefined() const {return kind != UNDEFINED;}
+    ///May the symbol be (re)defined as the given kind?
+    bool canDefineAs(Kind as) const {return kind == UNDEFINED || (kind == SET && as == SET);}
+};
+
+///Symbols by key, in an open-addressing hash table (linear probing). Entries are stored densely in order of first use, so
+///iterating is cheap and deterministic. References returned by get() are invalidated by the next insertion.
+class SymbolTable {
+public:
+    ///A key and its symbol.
+    struct Entry {
+        symbol_key_t key;
+        Symbol symbol;
+    };
+    ///Constructor (empty table).
+    SymbolTable();
+    ///Symbol with the given key; inserts an undefined symbol if there is none.
+    Symbol &get(symbol_key_t key);
+    ///Symbol with the given key, or nullptr.
+    const Symbol *find(symbol_key_t key) const;
+    ///Remove all symbols (keeps the allocated capacity for the next run).
+    void clear();
+    ///Number of symbols.
+    size_t size() const {return entries.size();}
+    ///All entries, in order of first use.
+    const std::vector<Entry> &getEntries() const {return entries;}
+    std::vector<Entry> &getEntries() {return entries;}
+private:
+    ///Symbols in order of first use.
+    std::vector<Entry> entries;
+    ///Index + 1 of the entry in each slot; 0 marks an empty slot. Size is a power of 2.
+    std::vector<uint_least32_t> buckets;
+    ///Hash function (64-bit mix; keys are small and dense, so they must be spread out).
+    static size_t hash(symbol_key_t key);
+    ///Double the hash table.
+    void grow();
+};
+
+#endif // SYMBOLTABLE_H
@@ -23,7 +23,6 @@ furnished to do so, subject to the following conditions:
 #include <Qt>
 #include <QColor>
 #include <QFont>
-#include <sstream>
 
 ///Format for character errors (Tokenizer::CHAR_ERROR; unrecognized character)
 inline static QTextCharFormat charErrorFormat() {
@@ -61,6 +60,8 @@ inline static QTextCharFormat numberFormat() {
 #define hexNumberFormat() numberFormat() //use the same as for Tokenizer::NUMBER
 #define octNumberFormat() numberFormat()
 #define binNumberFormat() numberFormat()
+///Format for strings and character constants (Tokenizer::STRING)
+#define stringFormat() numberFormat()
 ///Format for comments (Tokenizer::COMMENT)
 inline static QTextCharFormat commentFormat() {
     QTextCharFormat format;
@@ -79,6 +80,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter
     highlightingRules[Tokenizer::WHITESPACE] = defaultFormat;   //
     highlightingRules[Tokenizer::NEWLINE] = defaultFormat;      //Leave whitespaces, newlines and separators as-it-is
     highlightingRules[Tokenizer::SEPARATOR] = defaultFormat;    //
+    highlightingRules[Tokenizer::OPERATOR] = defaultFormat;     //
     highlightingRules[Tokenizer::OPCODE] = opcodeFormat();
     highlightingRules[Tokenizer::PSEUDOCODE] = pseudocodeFormat();
     highlightingRules[Tokenizer::IDENTIFIER] = identifierFormat();
@@ -86,12 +88,13 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *parent) : QSyntaxHighlighter
     highlightingRules[Tokenizer::HEXNUMBER] = hexNumberFormat();
     highlightingRules[Tokenizer::OCTNUMBER] = octNumberFormat();
     highlightingRules[Tokenizer::BINNUMBER] = binNumberFormat();
+    highlightingRules[Tokenizer::STRING] = stringFormat();
     highlightingRules[Tokenizer::COMMENT] = commentFormat();
 }
 void SyntaxHighlighter::highlightBlock(const QString &text) {
     //we know text will be a single line. Blocks are single lines in QPlainTextEdit.
     const std::string stdText = text.toStdString();
-    std::stringstream stream(stdText); Tokenizer tok(stream);
+    Tokenizer tok(stdText);
     int oldIndex = 0; //The index at which the previous token ended (and the next token will start)
     do {
         tok.getNextToken();
@@ -99,7 +102,7 @@ void SyntaxHighlighter::highlightBlock(const QString &text) {
             if(oldIndex < text.length())setFormat(oldIndex, 1, highlightingRules[Tokenizer::CHAR_ERROR]);
             oldIndex++; tok.getNextChar(); continue;
         }
-        int newIndex = tok.charNumber(); if(newIndex == -1) newIndex = text.length();
+        int newIndex = tok.charNumber();
         if(oldIndex < text.length() && newIndex <= text.length())
             setFormat(oldIndex, newIndex - oldIndex, highlightingRules[tok.ttype]);
         oldIndex = newIndex;
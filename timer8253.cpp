@@ -0,0 +1,269 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "timer8253.h"
+
+///Convert a 4-decade BCD value into binary.
+static data16_calc_t fromBCD(data16_calc_t value) {
+    return ((value >> 12) & 0xFu) * 1000u + ((value >> 8) & 0xFu) * 100u + ((value >> 4) & 0xFu) * 10u + (value & 0xFu);
+}
+///Convert a binary value (mod 10000) into 4-decade BCD.
+static data16_calc_t toBCD(data16_calc_t value) {
+    value %= 10000u;
+    return ((value / 1000u) << 12) | (((value / 100u) % 10u) << 8) | (((value / 10u) % 10u) << 4) | (value % 10u);
+}
+
+Timer8253::Timer8253(Processor *processor, cycles_t cyclesPerTick)
+    : processor(processor), cyclesPerTick(cyclesPerTick ? cyclesPerTick : 1u) {
+    for(unsigned i = 0; i < COUNTERS; i++) {
+        counters[i].gate = true; counters[i].line = NO_INTERRUPT; counters[i].level = false; counters[i].generation = 0u;
+    }
+    reset();
+}
+
+cycles_t Timer8253::elapsed(const Counter &c, cycles_t t) {
+    if(c.paused) return c.base;
+    return c.base + (t > c.start ? t - c.start : 0u);
+}
+void Timer8253::settle(Counter &c, cycles_t t) {
+    if(c.pending && t >= c.pendingStart) {
+        c.count = c.pendingCount; c.start = c.pendingStart; c.base = 0u;
+        c.levelBeforeStart = true; c.pending = c.nullCount = false;
+    }
+}
+bool Timer8253::outputAt(const Counter &c, cycles_t t) {
+    if(!c.armed) return c.idleLevel;
+    if((c.mode == 2u || c.mode == 3u) && !c.gate) return true; //gate low forces the output high in modes 2 and 3
+    if(t < c.start) return c.levelBeforeStart;
+    cycles_t e = elapsed(c, t);
+    switch(c.mode) {
+    case 0u: case 1u: return e >= c.count;                      //low until terminal count
+    case 4u: case 5u: return e != c.count;                      //low for one clock at terminal count
+    case 2u: return e % c.count != c.count - 1u;                //low for one clock every count clocks
+    default: return e % c.count < (c.count + 1u) / 2u;          //high for the (larger) first half of every period
+    }
+}
+data16_calc_t Timer8253::countAt(const Counter &c, cycles_t t) {
+    data16_calc_t value;
+    if(!c.armed || t < c.start) value = c.count;
+    else {
+        cycles_t e = elapsed(c, t);
+        switch(c.mode) {
+        case 0u: case 1u: case 4u: case 5u: value = (c.count + modulus(c) - e % modulus(c)) % modulus(c); break;
+        case 2u: value = c.count - e % c.count; break;
+        default: { //counts down by 2 through each half period
+            cycles_t phase = e % c.count, half = (c.count + 1u) / 2u;
+            value = c.count - 2u * (phase < half ? phase : phase - half);
+        }
+        }
+    }
+    return c.bcd ? toBCD(value) : value & 0xFFFFu;
+}
+cycles_t Timer8253::phaseNextChange(const Counter &c, cycles_t t) {
+    if(!c.armed || c.paused) return CYCLES_MAX;
+    if(t < c.start) {
+        if(outputAt(c, c.start) != c.levelBeforeStart) return c.start;
+        t = c.start;
+    }
+    cycles_t e = elapsed(c, t);
+    switch(c.mode) {
+    case 0u: case 1u: return e < c.count ? t + (c.count - e) : CYCLES_MAX;
+    case 4u: case 5u: return e < c.count ? t + (c.count - e) : (e == c.count ? t + 1u : CYCLES_MAX);
+    case 2u: {
+        cycles_t phase = e % c.count;
+        return phase < c.count - 1u ? t + (c.count - 1u - phase) : t + 1u;
+    }
+    default: {
+        cycles_t phase = e % c.count, half = (c.count + 1u) / 2u;
+        return phase < half ? t + (half - phase) : t + (c.count - phase);
+    }
+    }
+}
+cycles_t Timer8253::nextChange(const Counter &c, cycles_t t) {
+    cycles_t next = phaseNextChange(c, t);
+    if(c.pending && next >= c.pendingStart) { //the reload comes first
+        Counter after = c; settle(after, c.pendingStart);
+        if(outputAt(after, c.pendingStart) != outputAt(c, c.pendingStart - 1u)) return c.pendingStart;
+        return phaseNextChange(after, c.pendingStart);
+    }
+    return next;
+}
+void Timer8253::load(Counter &c, data16_calc_t count, cycles_t t, bool levelBefore) {
+    if((c.mode == 2u || c.mode == 3u) && count < 2u) count = 2u; //a count of 1 is illegal in modes 2 and 3
+    c.armed = true; c.count = count; c.start = t + 1u; c.base = 0u; c.levelBeforeStart = levelBefore;
+    c.paused = !c.gate && (c.mode == 0u || c.mode == 4u);
+    c.pending = c.nullCount = false;
+}
+void Timer8253::countComplete(Counter &c, cycles_t t) {
+    c.countWritten = c.nullCount = true;
+    switch(c.mode) {
+    case 0u: load(c, c.countRegister, t, false); break;
+    case 4u: load(c, c.countRegister, t, true); break;
+    case 2u: case 3u:
+        if(!c.gate) break; //loaded on the next rising edge of the gate
+        if(c.armed && t >= c.start) { //the new count takes effect at the end of the current period
+            c.pending = true;
+            c.pendingCount = c.countRegister < 2u ? 2u : c.countRegister;
+            c.pendingStart = t + (c.count - elapsed(c, t) % c.count);
+        }
+        else load(c, c.countRegister, t, true);
+        break;
+    default: break; //modes 1 and 5 wait for a trigger on the gate
+    }
+}
+void Timer8253::drive(Counter &c, bool level) {
+    if(level != c.level) {c.level = level; processor->setInterruptLine(c.line, level);}
+}
+void Timer8253::update(unsigned index, cycles_t t) {
+    Counter &c = counters[index];
+    c.generation++; //invalidates any event scheduled for the previous state
+    if(c.line == NO_INTERRUPT) return;
+    drive(c, outputAt(c, t));
+    cycles_t next = nextChange(c, t);
+    if(next == CYCLES_MAX) return;
+    unsigned long long generation = c.generation;
+    processor->scheduleEvent(next * cyclesPerTick, [this, index, generation, next](){
+        Counter &c = counters[index];
+        if(c.generation != generation) return;
+        cycles_t now = tickAt(processor->getCycleCount());
+        //Several transitions may fall within one instruction; replay them in order so that no edge is lost.
+        for(cycles_t at = next; at < now; at = nextChange(c, at)) {settle(c, at); drive(c, outputAt(c, at));}
+        settle(c, now);
+        update(index, now);
+    });
+}
+
+data8_t Timer8253::read(memaddr_t reg, cycles_t now) {
+    if(reg >= COUNTERS) return 0xFFu; //the control register cannot be read
+    cycles_t t = tickAt(now);
+    Counter &c = counters[reg];
+    settle(c, t);
+    if(c.statusLatched) {c.statusLatched = false; return c.statusValue;}
+    data16_calc_t value = c.latched ? c.latchValue : countAt(c, t);
+    switch(c.rw) {
+    case 1u: c.latched = false; return value & 0xFFu;
+    case 2u: c.latched = false; return (value >> 8) & 0xFFu;
+    default:
+        if(!c.readHigh) {c.readHigh = true; return value & 0xFFu;}
+        c.readHigh = c.latched = false; return (value >> 8) & 0xFFu;
+    }
+}
+void Timer8253::write(memaddr_t reg, data8_t data, cycles_t now) {
+    cycles_t t = tickAt(now);
+    if(reg >= COUNTERS) { //control word
+        unsigned select = (data >> 6) & 3u;
+        if(select == 3u) { //read-back command (8254)
+            for(unsigned i = 0; i < COUNTERS; i++) if(data & (2u << i)) {
+                Counter &c = counters[i];
+                settle(c, t);
+                if(!(data & 0x10u) && !c.statusLatched) {
+                    c.statusLatched = true;
+                    c.statusValue = (outputAt(c, t) ? 0x80u : 0u) | (c.nullCount ? 0x40u : 0u) | (c.rw << 4) |
+                            (c.modeBits << 1) | (c.bcd ? 1u : 0u);
+                }
+                if(!(data & 0x20u) && !c.latched) {c.latched = true; c.latchValue = countAt(c, t);}
+            }
+            return;
+        }
+        Counter &c = counters[select];
+        settle(c, t);
+        unsigned rw = (data >> 4) & 3u;
+        if(!rw) { //counter latch command
+            if(!c.latched) {c.latched = true; c.latchValue = countAt(c, t);}
+            return;
+        }
+        c.rw = rw; c.modeBits = (data >> 1) & 7u; c.mode = c.modeBits > 5u ? c.modeBits - 4u : c.modeBits;
+        c.bcd = data & 1u;
+        c.writeHigh = c.readHigh = c.latched = c.statusLatched = c.countWritten = false; c.nullCount = true;
+        c.armed = c.paused = c.pending = false; c.idleLevel = c.mode != 0u; //mode 0 sets the output low, the others high
+        update(select, t);
+        return;
+    }
+    Counter &c = counters[reg];
+    settle(c, t);
+    switch(c.rw) {
+    case 1u: c.countRegister = data; break;
+    case 2u: c.countRegister = (data << 8) & 0xFF00u; break;
+    default:
+        if(!c.writeHigh) {
+            c.lowByte = data; c.writeHigh = true;
+            if(c.mode == 0u) {c.armed = false; c.idleLevel = false; update(reg, t);} //writing the first byte stops counting
+            return;
+        }
+        c.writeHigh = false; c.countRegister = PACK(data, c.lowByte);
+    }
+    if(c.bcd) c.countRegister = fromBCD(c.countRegister);
+    if(!c.countRegister) c.countRegister = modulus(c); //0 stands for the largest count
+    countComplete(c, t);
+    update(reg, t);
+}
+void Timer8253::reset() {
+    for(unsigned i = 0; i < COUNTERS; i++) {
+        Counter &c = counters[i];
+        if(c.line != NO_INTERRUPT && c.level) processor->setInterruptLine(c.line, false);
+        c.level = false;
+        c.modeBits = c.mode = 0u; c.rw = 3u; c.bcd = false;
+        c.writeHigh = c.readHigh = false; c.lowByte = 0u;
+        c.countRegister = c.count = 0x10000u; c.countWritten = c.nullCount = false;
+        c.latched = c.statusLatched = false; c.latchValue = 0u; c.statusValue = 0u;
+        c.idleLevel = false; c.armed = c.paused = c.pending = c.levelBeforeStart = false;
+        c.start = c.base = c.pendingStart = 0u; c.pendingCount = 0u;
+        c.generation++; //drop events scheduled before the reset
+    }
+}
+
+void Timer8253::connectOutput(unsigned index, InterruptLine line) {
+    if(index >= COUNTERS) return;
+    Counter &c = counters[index];
+    if(c.line != NO_INTERRUPT && c.level) processor->setInterruptLine(c.line, false); //release the old line
+    c.line = line; c.level = false;
+    cycles_t t = tickAt(processor->getCycleCount());
+    settle(c, t);
+    update(index, t);
+}
+void Timer8253::setGate(unsigned index, bool level) {
+    if(index >= COUNTERS) return;
+    Counter &c = counters[index];
+    cycles_t t = tickAt(processor->getCycleCount());
+    settle(c, t);
+    if(c.gate == level) return;
+    c.gate = level;
+    switch(c.mode) {
+    case 0u: case 4u: //gate low suspends counting
+        if(!c.armed) break;
+        if(!level) {c.base = elapsed(c, t); c.paused = true;}
+        else {c.paused = false; if(c.start < t) c.start = t;}
+        break;
+    case 2u: case 3u: //gate low stops counting (output high); a rising edge reloads the count
+        if(!level) {if(c.armed) {c.base = elapsed(c, t); c.paused = true; c.pending = false;}}
+        else if(c.countWritten) load(c, c.countRegister, t, true);
+        break;
+    default: //a rising edge (re)triggers
+        if(level && c.countWritten) load(c, c.countRegister, t, outputAt(c, t));
+    }
+    update(index, t);
+}
+bool Timer8253::getOutput(unsigned index) {
+    if(index >= COUNTERS) return false;
+    cycles_t t = tickAt(processor->getCycleCount());
+    settle(counters[index], t);
+    return outputAt(counters[index], t);
+}
@@ -0,0 +1,154 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef TIMER8253_H
+#define TIMER8253_H
+
+#include "processor.h"
+
+///Models an 8253/8254 programmable interval timer (three 16-bit down counters and a control register at register offsets 0 to
+///3). All six counter modes, binary/BCD counting, counter latch commands and the 8254 read-back command are supported.
+///
+///The counters are never ticked. Each counter remembers when its current count was loaded and computes its count element and
+///output from the elapsed clock ticks whenever it is accessed. Outputs wired to an interrupt line are the only exception: for
+///those, a single event is scheduled on the processor at the next output transition, so that the line is driven on time.
+///
+///All counters share one clock input derived from the processor clock (cyclesPerTick processor T-states per timer clock). The
+///timer schedules events which refer to itself, so it must outlive the processor it is connected to (or the processor's
+///scheduled events must be cleared before the timer is destroyed).
+class Timer8253 : public IODevice {
+public:
+    ///Number of counters in the timer.
+    static const unsigned COUNTERS = 3u;
+private:
+    ///State of one counter.
+    struct Counter {
+        ///Mode bits (M2 M1 M0) as written in the control word; used for the status byte.
+        unsigned modeBits;
+        ///Effective mode (0 to 5; modes 6 and 7 are aliases of 2 and 3).
+        unsigned mode;
+        ///Read/write format (RW1 RW0): 1 = LSB only, 2 = MSB only, 3 = LSB then MSB.
+        unsigned rw;
+        ///True if counting in BCD (4 decades).
+        bool bcd;
+        ///Next byte written is the MSB (for rw == 3).
+        bool writeHigh;
+        ///Next byte read is the MSB (for rw == 3).
+        bool readHigh;
+        ///LSB of a count whose MSB has not been written yet.
+        data8_t lowByte;
+        ///Count register (as a binary value, with 0 already converted to the modulus).
+        data16_calc_t countRegister;
+        ///True if countRegister has been written since the last control word.
+        bool countWritten;
+        ///True if a count has been written but not yet loaded into the count element.
+        bool nullCount;
+        ///True if a counter latch command is pending; latchValue is then returned instead of the live count.
+        bool latched;
+        ///Latched count (as it would be read, i.e. BCD-encoded if counting in BCD).
+        data16_calc_t latchValue;
+        ///True if a status byte (8254 read-back) is pending; it is read before any latched count.
+        bool statusLatched;
+        ///Latched status byte.
+        data8_t statusValue;
+        ///Gate input level.
+        bool gate;
+        ///Output level while no count is loaded (after a control word).
+        bool idleLevel;
+        ///True if a count is loaded and counting (or done counting).
+        bool armed;
+        ///Count loaded into the count element at tick start.
+        data16_calc_t count;
+        ///Timer tick at which the count element holds count.
+        cycles_t start;
+        ///Decrements made before counting was last paused (modes 0 and 4 with gate low).
+        cycles_t base;
+        ///Counting is suspended by the gate (modes 0 and 4 only).
+        bool paused;
+        ///Output level before tick start (while the new count is being loaded).
+        bool levelBeforeStart;
+        ///A new count is to be loaded at tick pendingStart (modes 2 and 3 take a new count at the end of the current period).
+        bool pending;
+        ///Count to load at tick pendingStart.
+        data16_calc_t pendingCount;
+        ///Tick at which pendingCount is loaded.
+        cycles_t pendingStart;
+        ///Interrupt line the output is wired to.
+        InterruptLine line;
+        ///Output level last driven onto line.
+        bool level;
+        ///Incremented on every state change; scheduled output events carrying an older generation are ignored.
+        unsigned long long generation;
+    };
+    ///Processor this timer is connected to (for scheduling output events and driving interrupt lines).
+    Processor * const processor;
+    ///Processor clock cycles (T-states) per timer clock tick.
+    cycles_t cyclesPerTick;
+    ///The three counters.
+    Counter counters[COUNTERS];
+
+    ///Timer tick (clock pulses since RESET_IN) at processor cycle count now.
+    cycles_t tickAt(cycles_t now) const {return now / cyclesPerTick;}
+    ///Modulus of counter c (65536 in binary, 10000 in BCD).
+    static data16_calc_t modulus(const Counter &c) {return c.bcd ? 10000u : 0x10000u;}
+    ///Decrements made by counter c by tick t since its count was loaded.
+    static cycles_t elapsed(const Counter &c, cycles_t t);
+    ///If a pending reload of counter c is due by tick t, perform it.
+    static void settle(Counter &c, cycles_t t);
+    ///Output level of counter c at tick t (c must be settled at t).
+    static bool outputAt(const Counter &c, cycles_t t);
+    ///Value of the count element of counter c at tick t, as it would be read (c must be settled at t).
+    static data16_calc_t countAt(const Counter &c, cycles_t t);
+    ///First tick after t at which the output of counter c changes, ignoring any pending reload; CYCLES_MAX if never.
+    static cycles_t phaseNextChange(const Counter &c, cycles_t t);
+    ///First tick after t at which the output of counter c changes; CYCLES_MAX if never.
+    static cycles_t nextChange(const Counter &c, cycles_t t);
+    ///(Re)load counter c with count at tick t; counting starts on the next clock pulse. levelBefore is the output level until then.
+    static void load(Counter &c, data16_calc_t count, cycles_t t, bool levelBefore);
+    ///Handle a completely written count for counter c at tick t.
+    static void countComplete(Counter &c, cycles_t t);
+    ///Drive the interrupt line of counter c to level, if it is not already at that level.
+    void drive(Counter &c, bool level);
+    ///Bring the interrupt line of counter index up to date at tick t and schedule an event at its next output transition.
+    void update(unsigned index, cycles_t t);
+public:
+    ///Constructor. The timer clock is the processor clock divided by cyclesPerTick (at least 1).
+    explicit Timer8253(Processor *processor, cycles_t cyclesPerTick = 1u);
+
+    data8_t read(memaddr_t reg, cycles_t now); //override
+    void write(memaddr_t reg, data8_t data, cycles_t now); //override
+    void reset(); //override
+
+    ///Set the number of processor T-states per timer clock tick (at least 1). Call this only while no counter is running, e.g.
+    ///right after RESET_IN.
+    void setCyclesPerTick(cycles_t value) {cyclesPerTick = value ? value : 1u;}
+    ///Get the number of processor T-states per timer clock tick.
+    cycles_t getCyclesPerTick() const {return cyclesPerTick;}
+    ///Wire the output of counter index to interrupt line (NO_INTERRUPT to disconnect). The line is driven immediately to the
+    ///current output level.
+    void connectOutput(unsigned index, InterruptLine line);
+    ///Set the gate input of counter index at the current processor cycle count. Gates are high after reset.
+    void setGate(unsigned index, bool level);
+    ///Get the output level of counter index at the current processor cycle count.
+    bool getOutput(unsigned index);
+};
+
+#endif // TIMER8253_H
@@ -0,0 +1,104 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include <QPainter>
+#include <QPolygonF>
+#include <QPointF>
+#include <QColor>
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QPushButton>
+#include "trainerpanel.h"
+
+SevenSegmentDisplay::SevenSegmentDisplay(QWidget *parent) : QWidget(parent), characters(6, '\0') {
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+}
+QSize SevenSegmentDisplay::sizeHint() const {return QSize(40 * characters.size() + 8, 72);} //override
+void SevenSegmentDisplay::setCharacters(const QByteArray &characters) {
+    if(characters == this->characters) return;
+    const bool resized = characters.size() != this->characters.size();
+    this->characters = characters;
+    if(resized) updateGeometry();
+    update();
+}
+void SevenSegmentDisplay::paintEvent(QPaintEvent *) {//override
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), QColor(24, 8, 8));
+    painter.setPen(Qt::NoPen);
+    //Segments of a digit 20 units wide and 40 high (plus 2 units of thickness all around, and the decimal point at the right),
+    //with the bit driving each of them.
+    static const qreal horizontal[][2] = {{2.0, 0.0}, {2.0, 20.0}, {2.0, 40.0}}; //a, g, d
+    static const qreal vertical[][2] = {{20.0, 0.0}, {20.0, 20.0}, {0.0, 20.0}, {0.0, 0.0}}; //b, c, e, f
+    static const int horizontalBits[] = {4, 2, 7}, verticalBits[] = {5, 6, 0, 1};
+    const qreal cell = (qreal)width() / (characters.isEmpty() ? 1 : characters.size());
+    const qreal scale = qMin(cell / 32.0, (qreal)height() / 56.0);
+    for(int i = 0; i < characters.size(); i++) {
+        const unsigned segments = (unsigned char)characters[i];
+        painter.save();
+        painter.translate(cell * i + (cell - 28.0 * scale) / 2.0 + 2.0 * scale, ((qreal)height() - 44.0 * scale) / 2.0 + 2.0 * scale);
+        painter.scale(scale, scale);
+        const auto segment = [&](bool lit, const QPolygonF &shape) {
+            painter.setBrush(lit ? QColor(255, 40, 24) : QColor(60, 16, 12));
+            painter.drawPolygon(shape);
+        };
+        for(int k = 0; k < 3; k++) {
+            const qreal x = horizontal[k][0], y = horizontal[k][1];
+            segment(segments & (1u << horizontalBits[k]), QPolygonF() << QPointF(x, y) << QPointF(x + 2.0, y - 2.0) << QPointF(x + 14.0, y - 2.0)
+                    << QPointF(x + 16.0, y) << QPointF(x + 14.0, y + 2.0) << QPointF(x + 2.0, y + 2.0));
+        }
+        for(int k = 0; k < 4; k++) {
+            const qreal x = vertical[k][0], y = vertical[k][1];
+            segment(segments & (1u << verticalBits[k]), QPolygonF() << QPointF(x, y + 2.0) << QPointF(x + 2.0, y + 4.0) << QPointF(x + 2.0, y + 16.0)
+                    << QPointF(x, y + 18.0) << QPointF(x - 2.0, y + 16.0) << QPointF(x - 2.0, y + 4.0));
+        }
+        painter.setBrush((segments & 0x08u) ? QColor(255, 40, 24) : QColor(60, 16, 12)); //decimal point
+        painter.drawEllipse(QPointF(24.0, 40.0), 1.8, 1.8);
+        painter.restore();
+    }
+}
+
+TrainerPanel::TrainerPanel(QWidget *parent) : QWidget(parent), display(new SevenSegmentDisplay(this)) {
+    //Keypad of the SDK-85, row by row. Codes below 0 are the keys wired to the processor.
+    enum {RESET_KEY = -1, VECT_INTR_KEY = -2};
+    static const struct {const char *label; int code;} keys[4][6] = {
+        {{"RESET", RESET_KEY}, {"VECT\nINTR", VECT_INTR_KEY}, {"C", 0x0C}, {"D", 0x0D}, {"E", 0x0E}, {"F", 0x0F}},
+        {{"SINGLE\nSTEP", 0x15}, {"GO", 0x12}, {"8", 0x08}, {"9", 0x09}, {"A", 0x0A}, {"B", 0x0B}},
+        {{"SUBST\nMEM", 0x13}, {"EXAM\nREG", 0x14}, {"4", 0x04}, {"5", 0x05}, {"6", 0x06}, {"7", 0x07}},
+        {{"NEXT\n,", 0x11}, {"EXEC\n.", 0x10}, {"0", 0x00}, {"1", 0x01}, {"2", 0x02}, {"3", 0x03}}
+    };
+    QGridLayout *keypad = new QGridLayout();
+    for(int row = 0; row < 4; row++) for(int column = 0; column < 6; column++) {
+        QPushButton *button = new QPushButton(QString(keys[row][column].label), this);
+        button->setFocusPolicy(Qt::NoFocus);
+        button->setMinimumHeight(40);
+        const int code = keys[row][column].code;
+        switch(code) {
+        case RESET_KEY: connect(button, &QPushButton::clicked, this, &TrainerPanel::resetPressed); break;
+        case VECT_INTR_KEY: connect(button, &QPushButton::clicked, this, &TrainerPanel::vectorInterruptPressed); break;
+        default: connect(button, &QPushButton::clicked, this, [this, code](){emit keyPressed((data8_t)code);}); break;
+        }
+        keypad->addWidget(button, row, column);
+    }
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(display);
+    layout->addLayout(keypad);
+}
@@ -0,0 +1,75 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef TRAINERPANEL_H
+#define TRAINERPANEL_H
+
+#include <QWidget>
+#include <QObject>
+#include <QByteArray>
+#include <QPaintEvent>
+#include <QSize>
+#include "commdefs.h"
+
+///Row of 7-segment digits showing the characters of an 8279 display (see Keyboard8279::getDisplay()). Each byte drives the
+///segments of one digit with the bit layout of the SDK-85: D7 to D0 are segments d, c, b, a, the decimal point, g, f and e
+///(a set bit lights the segment).
+class SevenSegmentDisplay : public QWidget {
+    Q_OBJECT
+public:
+    ///Constructor (6 blank digits, as on the SDK-85)
+    SevenSegmentDisplay(QWidget *parent = nullptr);
+    ///Calculate (preferred) size for this component.
+    QSize sizeHint() const; //override
+public slots:
+    ///Show characters, one byte per digit (left to right).
+    void setCharacters(const QByteArray &characters);
+protected:
+    ///Paint the digits.
+    void paintEvent(QPaintEvent *event); //override
+private:
+    ///Segment bytes being shown.
+    QByteArray characters;
+};
+
+///Front panel of an SDK-85 style trainer: the 7-segment display and the 24 key keypad. The hexadecimal and command keys send
+///8279 key codes (0 to F are 00H to 0FH, then EXEC 10H, NEXT 11H, GO 12H, SUBST MEM 13H, EXAM REG 14H and SINGLE STEP 15H);
+///RESET and VECT INTR are wired to the processor instead.
+class TrainerPanel : public QWidget {
+    Q_OBJECT
+public:
+    ///Constructor
+    TrainerPanel(QWidget *parent = nullptr);
+    ///The display
+    SevenSegmentDisplay *getDisplay() const {return display;}
+signals:
+    ///A key wired to the 8279 was pressed; code is its key code.
+    void keyPressed(data8_t code);
+    ///RESET was pressed.
+    void resetPressed();
+    ///VECT INTR was pressed (RST 7.5 on the SDK-85).
+    void vectorInterruptPressed();
+private:
+    ///The display
+    SevenSegmentDisplay *display;
+};
+
+#endif // TRAINERPANEL_H
@@ -0,0 +1,126 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#include "usart8251.h"
+
+//Command word bits
+#define USART_TXEN  0x01u
+#define USART_RXE   0x04u
+#define USART_IR    0x40u
+//Status word bits
+#define USART_TXRDY     0x01u
+#define USART_RXRDY     0x02u
+#define USART_TXEMPTY   0x04u
+#define USART_DSR       0x80u
+
+Usart8251::Usart8251(Processor *processor, SerialEndpoint *endpoint, cycles_t cyclesPerBit)
+    : processor(processor), endpoint(endpoint), cyclesPerBit(cyclesPerBit ? cyclesPerBit : 1u),
+      rxReadyLine(NO_INTERRUPT), rxReadyLevel(false), generation(0u) {
+    reset();
+}
+
+void Usart8251::decodeMode() {
+    unsigned length = 5u + ((modeWord >> 2) & 3u), parity = (modeWord & 0x10u) ? 1u : 0u;
+    charMask = (1u << length) - 1u;
+    if(!(modeWord & 3u)) frameHalfBits = 2u * (length + parity); //synchronous: no start or stop bits
+    else {
+        unsigned stopHalfBits = (modeWord >> 6) & 3u; //1, 1.5 or 2 stop bits (0 is invalid; treated as 1)
+        frameHalfBits = 2u * (1u + length + parity) + (stopHalfBits ? stopHalfBits + 1u : 2u);
+    }
+}
+void Usart8251::send(data8_t data, cycles_t now) {
+    if(now >= shiftFreeAt) {holdingFreeAt = now; shiftFreeAt = now + frameCycles();}
+    else {holdingFreeAt = shiftFreeAt; shiftFreeAt += frameCycles();}
+    if(endpoint) endpoint->transmit(data & charMask);
+}
+void Usart8251::pollReceiver(cycles_t now) {
+    data8_t byte;
+    if(expectMode || syncCharsLeft || !(command & USART_RXE) || rxFull || now < rxNextAt || !endpoint) return;
+    if(endpoint->receive(byte)) {rxData = byte & charMask; rxFull = true; rxNextAt = now + frameCycles();}
+}
+void Usart8251::update(cycles_t now) {
+    generation++; //invalidates any poll scheduled for the previous state
+    if(rxReadyLine == NO_INTERRUPT) return;
+    if(rxFull != rxReadyLevel) {rxReadyLevel = rxFull; processor->setInterruptLine(rxReadyLine, rxFull);}
+    if(rxFull || expectMode || syncCharsLeft || !(command & USART_RXE)) return;
+    cycles_t when = now + frameCycles();
+    if(when < rxNextAt) when = rxNextAt;
+    unsigned long long current = generation;
+    processor->scheduleEvent(when, [this, current](){
+        if(generation != current) return;
+        cycles_t now = processor->getCycleCount();
+        pollReceiver(now);
+        update(now);
+    });
+}
+
+data8_t Usart8251::read(memaddr_t reg, cycles_t now) {
+    pollReceiver(now);
+    if(reg & 1u) { //status
+        data8_t status = USART_DSR;
+        if(rxFull) status |= USART_RXRDY;
+        if(!holdingPending && now >= holdingFreeAt) status |= USART_TXRDY;
+        if(!holdingPending && now >= shiftFreeAt) status |= USART_TXEMPTY;
+        return status;
+    }
+    data8_t data = rxData;
+    if(rxFull) {rxFull = false; update(now);}
+    return data;
+}
+void Usart8251::write(memaddr_t reg, data8_t data, cycles_t now) {
+    if(!(reg & 1u)) { //data
+        if(expectMode || syncCharsLeft) return;
+        if(command & USART_TXEN) send(data, now);
+        else {holding = data; holdingPending = true;}
+        return;
+    }
+    if(expectMode) {
+        modeWord = data; expectMode = false;
+        if(!(data & 3u)) syncCharsLeft = (data & 0x80u) ? 1u : 2u; //single or double sync character
+        decodeMode();
+        update(now);
+        return;
+    }
+    if(syncCharsLeft) {syncCharsLeft--; update(now); return;}
+    if(data & USART_IR) { //internal reset; the next control write is a mode word
+        expectMode = true; command = 0u; holdingPending = rxFull = false;
+        update(now);
+        return;
+    }
+    command = data;
+    if((command & USART_TXEN) && holdingPending) {holdingPending = false; send(holding, now);}
+    update(now);
+}
+void Usart8251::reset() {
+    if(rxReadyLine != NO_INTERRUPT && rxReadyLevel) processor->setInterruptLine(rxReadyLine, false);
+    rxReadyLevel = false;
+    expectMode = true; syncCharsLeft = 0u; modeWord = 0x4Eu; command = 0u; //8 data bits, 1 stop bit, no parity until told
+    decodeMode();
+    holding = rxData = 0u; holdingPending = rxFull = false;
+    holdingFreeAt = shiftFreeAt = rxNextAt = 0u;
+    generation++; //drop polls scheduled before the reset
+}
+
+void Usart8251::connectRxReady(InterruptLine line) {
+    if(rxReadyLine != NO_INTERRUPT && rxReadyLevel) processor->setInterruptLine(rxReadyLine, false); //release the old line
+    rxReadyLine = line; rxReadyLevel = false;
+    update(processor->getCycleCount());
+}
@@ -0,0 +1,104 @@
+/*MIT License
+
+Copyright (c) 2021 Chirantan Nath
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.*/
+#ifndef USART8251_H
+#define USART8251_H
+
+#include "processor.h"
+#include "serialendpoint.h"
+
+///Models an 8251 USART (data register at register offset 0, mode/command/status register at offset 1) connected to a host
+///serial endpoint. Asynchronous and synchronous mode words, the command word (TxEN, RxE, error reset, internal reset) and the
+///status word (TxRDY, RxRDY, TxEMPTY, DSR) are supported; the host line is error-free, so the error flags are never set.
+///
+///Line timing is modelled lazily from the processor cycle count: a transmitted character keeps the transmitter busy for one
+///frame (start, data, parity and stop bits at cyclesPerBit T-states per bit) and received characters are taken from the
+///endpoint no faster than one per frame, when the program looks at the status or data register. If the RxRDY output is wired to
+///an interrupt line, the endpoint is also polled by a scheduled event once per frame time while the receiver is enabled.
+class Usart8251 : public IODevice {
+    ///Processor this USART is connected to.
+    Processor * const processor;
+    ///Host side of the serial line (may be nullptr: transmitted characters are dropped and nothing is received).
+    SerialEndpoint *endpoint;
+    ///Processor clock cycles (T-states) per serial bit (the baud rate factor is already included).
+    cycles_t cyclesPerBit;
+    ///Length of one frame in half bits (stop bits may be 1.5 bits long).
+    unsigned frameHalfBits;
+    ///Mask for the configured character length.
+    data8_t charMask;
+    ///True after reset (or internal reset) until the mode word is written.
+    bool expectMode;
+    ///Synchronous mode: sync characters still expected after the mode word.
+    unsigned syncCharsLeft;
+    ///Last mode word.
+    data8_t modeWord;
+    ///Last command word.
+    data8_t command;
+    ///Character written while the transmitter was disabled (sent when TxEN is set).
+    data8_t holding;
+    ///True if holding is waiting for TxEN.
+    bool holdingPending;
+    ///Cycle count from which the transmit buffer is empty again.
+    cycles_t holdingFreeAt;
+    ///Cycle count from which the transmitter is idle.
+    cycles_t shiftFreeAt;
+    ///Received character waiting to be read.
+    data8_t rxData;
+    ///True if rxData has not been read yet (RxRDY).
+    bool rxFull;
+    ///Cycle count before which the next character cannot have arrived.
+    cycles_t rxNextAt;
+    ///Interrupt line the RxRDY output is wired to.
+    InterruptLine rxReadyLine;
+    ///Level last driven onto rxReadyLine.
+    bool rxReadyLevel;
+    ///Incremented on every state change; scheduled poll events carrying an older generation are ignored.
+    unsigned long long generation;
+
+    ///Processor cycles taken by one frame.
+    cycles_t frameCycles() const {return cyclesPerBit * frameHalfBits / 2u;}
+    ///Recompute frameHalfBits and charMask from the mode word.
+    void decodeMode();
+    ///Send data (the transmitter must be enabled) at cycle count now.
+    void send(data8_t data, cycles_t now);
+    ///Take the next character from the endpoint if the receiver is enabled and empty and it could have arrived by now.
+    void pollReceiver(cycles_t now);
+    ///Drive the RxRDY interrupt line to the current state and schedule the next poll if needed.
+    void update(cycles_t now);
+public:
+    ///Constructor.
+    Usart8251(Processor *processor, SerialEndpoint *endpoint, cycles_t cyclesPerBit);
+
+    data8_t read(memaddr_t reg, cycles_t now); //override
+    void write(memaddr_t reg, data8_t data, cycles_t now); //override
+    void reset(); //override
+
+    ///Change the host side of the serial line. Must not be called while the processor is running.
+    void setEndpoint(SerialEndpoint *value) {endpoint = value;}
+    ///Set the number of processor T-states per serial bit (at least 1).
+    void setCyclesPerBit(cycles_t value) {cyclesPerBit = value ? value : 1u;}
+    ///Get the number of processor T-states per serial bit.
+    cycles_t getCyclesPerBit() const {return cyclesPerBit;}
+    ///Wire the RxRDY output to interrupt line (NO_INTERRUPT to disconnect).
+    void connectRxReady(InterruptLine line);
+};
+
+#endif // USART8251_H